@@ -0,0 +1,287 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTemporaryDir>
+
+#include "Benchmark.h"
+
+#include "Generator.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  enum ExitCode : int {
+    ExitSuccess = 0,
+    ExitRegression,
+    ExitUsage,
+    ExitFailure
+  };
+
+  using Clock = std::chrono::steady_clock;
+
+  struct Result {
+    QString name;
+    double  us{0};
+  };
+
+  using Results = std::vector<Result>;
+
+  ////// Measure /////////////////////////////////////////////////////////////
+
+  // NOTE: Stores the checksums to defeat optimization.
+  volatile qsizetype sink = 0;
+
+  // Best of "runs", in microseconds per run; negative on failure
+  double measure(const BenchmarkFunc& func, const int runs)
+  {
+    double best = 0;
+    for(int run = 0; run < runs; run++) {
+      const Clock::time_point start = Clock::now();
+
+      const qsizetype checksum = func();
+
+      const std::chrono::duration<double,std::micro> elapsed = Clock::now() - start;
+
+      if( checksum < 0 ) {
+        return -1;
+      }
+      sink = checksum;
+
+      if( run == 0  ||  elapsed.count() < best ) {
+        best = elapsed.count();
+      }
+    }
+
+    return best;
+  }
+
+  ////// Baseline ////////////////////////////////////////////////////////////
+
+  QJsonObject toJson(const GeneratorConfig& config)
+  {
+    QJsonObject result;
+    result.insert(QStringLiteral("years"), config.years);
+    result.insert(QStringLiteral("items"), config.itemsPerMonth);
+    result.insert(QStringLiteral("projects"), config.projects);
+    result.insert(QStringLiteral("activity"), config.activityLength);
+    result.insert(QStringLiteral("seed"), qint64(config.seed));
+    return result;
+  }
+
+  bool readBaseline(QJsonObject& baseline, const QString& filename)
+  {
+    QFile file(filename);
+    if( !file.open(QIODevice::ReadOnly) ) {
+      return false;
+    }
+
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if( !doc.isObject() ) {
+      return false;
+    }
+
+    baseline = doc.object();
+
+    return true;
+  }
+
+  bool writeBaseline(const QString& filename, const GeneratorConfig& config,
+                     const Results& results)
+  {
+    QJsonObject values;
+    for(const Result& result : results) {
+      values.insert(result.name, result.us);
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("config"), toJson(config));
+    root.insert(QStringLiteral("results"), values);
+
+    QSaveFile file(filename);
+    if( !file.open(QIODevice::WriteOnly) ) {
+      return false;
+    }
+
+    file.write(QJsonDocument(root).toJson());
+
+    return file.commit();
+  }
+
+  ////// Command Line ////////////////////////////////////////////////////////
+
+  bool parseInt(int& value, const QString& text, const int min)
+  {
+    bool ok = false;
+    const int result = text.toInt(&ok);
+    if( !ok  ||  result < min ) {
+      return false;
+    }
+
+    value = result;
+
+    return true;
+  }
+
+} // namespace priv
+
+////// Public ////////////////////////////////////////////////////////////////
+
+int runBenchmarks(int argc, char **argv, const QString& description,
+                  Context& context, const MakeBenchmarks& make)
+{
+  QCoreApplication app(argc, argv);
+
+  // (1) Command Line ////////////////////////////////////////////////////////
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(description);
+  parser.addHelpOption();
+
+  const QCommandLineOption yearsOption(QStringLiteral("years"),
+                                       QStringLiteral("Number of generated years (default: 5)."),
+                                       QStringLiteral("n"), QStringLiteral("5"));
+  const QCommandLineOption itemsOption(QStringLiteral("items"),
+                                       QStringLiteral("Number of items per month (default: 20)."),
+                                       QStringLiteral("n"), QStringLiteral("20"));
+  const QCommandLineOption projectsOption(QStringLiteral("projects"),
+                                          QStringLiteral("Number of projects (default: 50)."),
+                                          QStringLiteral("n"), QStringLiteral("50"));
+  const QCommandLineOption activityOption(QStringLiteral("activity"),
+                                          QStringLiteral("Length of an activity (default: 40)."),
+                                          QStringLiteral("n"), QStringLiteral("40"));
+  const QCommandLineOption runsOption(QStringLiteral("runs"),
+                                      QStringLiteral("Number of runs per benchmark; the best run counts (default: 5)."),
+                                      QStringLiteral("n"), QStringLiteral("5"));
+  const QCommandLineOption baselineOption(QStringLiteral("baseline"),
+                                          QStringLiteral("Compare against the baseline <file>; fails on regression."),
+                                          QStringLiteral("file"));
+  const QCommandLineOption recordOption(QStringLiteral("record"),
+                                        QStringLiteral("Record the results as baseline <file>."),
+                                        QStringLiteral("file"));
+  const QCommandLineOption toleranceOption(QStringLiteral("tolerance"),
+                                           QStringLiteral("Allowed slowdown in percent (default: 25)."),
+                                           QStringLiteral("percent"), QStringLiteral("25"));
+  parser.addOptions({yearsOption, itemsOption, projectsOption, activityOption,
+                     runsOption, baselineOption, recordOption, toleranceOption});
+
+  parser.process(app);
+
+  GeneratorConfig config;
+  int runs = 0;
+  int tolerance = 0;
+  if( !priv::parseInt(config.years, parser.value(yearsOption), 1)  ||
+      !priv::parseInt(config.itemsPerMonth, parser.value(itemsOption), 0)  ||
+      !priv::parseInt(config.projects, parser.value(projectsOption), 1)  ||
+      !priv::parseInt(config.activityLength, parser.value(activityOption), 0)  ||
+      !priv::parseInt(runs, parser.value(runsOption), 1)  ||
+      !priv::parseInt(tolerance, parser.value(toleranceOption), 0) ) {
+    std::fprintf(stderr, "Invalid option value!\n");
+    return priv::ExitUsage;
+  }
+
+  QJsonObject baseline;
+  if( parser.isSet(baselineOption) ) {
+    if( !priv::readBaseline(baseline, parser.value(baselineOption)) ) {
+      std::fprintf(stderr, "Unable to read baseline \"%s\"!\n",
+                   qPrintable(parser.value(baselineOption)));
+      return priv::ExitUsage;
+    }
+
+    if( baseline.value(QStringLiteral("config")).toObject() != priv::toJson(config) ) {
+      std::fprintf(stderr, "Baseline was recorded with a different configuration!\n");
+      return priv::ExitUsage;
+    }
+  }
+
+  // (2) Data ////////////////////////////////////////////////////////////////
+
+  QTemporaryDir dir;
+  if( !dir.isValid() ) {
+    std::fprintf(stderr, "Unable to create temporary directory!\n");
+    return priv::ExitUsage;
+  }
+
+  context = generateContext(config);
+
+  // (3) Run /////////////////////////////////////////////////////////////////
+
+  const QJsonObject values = baseline.value(QStringLiteral("results")).toObject();
+
+  bool is_regression = false;
+  priv::Results results;
+  for(const Benchmark& bench : make(context, dir.path())) {
+    const double us = priv::measure(bench.func, runs);
+    if( us < 0 ) {
+      std::fprintf(stderr, "Benchmark \"%s\" failed!\n", qPrintable(bench.name));
+      return priv::ExitFailure;
+    }
+    results.push_back({bench.name, us});
+
+    std::printf("%-20s %12.1f us", qPrintable(bench.name), us);
+
+    const double reference = values.value(bench.name).toDouble(0);
+    if( reference > 0 ) {
+      const double change = (us/reference - 1)*100;
+      const bool is_slower = change > double(tolerance);
+
+      std::printf("  %12.1f us  %+7.1f %%%s", reference, change,
+                  is_slower ? "  REGRESSION" : "");
+
+      is_regression = is_regression  ||  is_slower;
+    }
+
+    std::printf("\n");
+  }
+
+  // (4) Record //////////////////////////////////////////////////////////////
+
+  if( parser.isSet(recordOption) ) {
+    if( !priv::writeBaseline(parser.value(recordOption), config, results) ) {
+      std::fprintf(stderr, "Unable to write baseline \"%s\"!\n",
+                   qPrintable(parser.value(recordOption)));
+      return priv::ExitUsage;
+    }
+  }
+
+  return is_regression
+      ? priv::ExitRegression
+      : priv::ExitSuccess;
+}
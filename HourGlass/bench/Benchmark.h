@@ -0,0 +1,67 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include <QtCore/QString>
+
+#include "Context.h"
+
+// NOTE: Returns a checksum to defeat optimization; cf. BENCHMARK_FAILED.
+using BenchmarkFunc = std::function<qsizetype()>;
+
+// NOTE: A negative checksum aborts the benchmark suite.
+constexpr qsizetype BENCHMARK_FAILED = -1;
+
+struct Benchmark {
+  QString       name;
+  BenchmarkFunc func;
+};
+
+using Benchmarks = std::vector<Benchmark>;
+
+// Creates the benchmarks of the generated "context"; "dir" is a temporary directory.
+using MakeBenchmarks = std::function<Benchmarks(const Context& context, const QString& dir)>;
+
+/*
+ * Parses the command line, generates "context", runs the benchmarks and
+ * compares them against a baseline. Returns the executable's exit code:
+ *
+ * 0: Success
+ * 1: Regression
+ * 2: Usage
+ * 3: Failure
+ */
+int runBenchmarks(int argc, char **argv, const QString& description,
+                  Context& context, const MakeBenchmarks& make);
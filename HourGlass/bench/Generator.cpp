@@ -0,0 +1,112 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <random>
+
+#include "Generator.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  constexpr int FIRST_YEAR = 2000;
+
+  using Engine = std::mt19937;
+
+  QString makeText(Engine& engine, const int length)
+  {
+    std::uniform_int_distribution<int> letter(0, 26);
+
+    QString result(length, QLatin1Char(' '));
+    for(QChar& ch : result) {
+      const int c = letter(engine);
+      if( c < 26 ) { // else: keep blank
+        ch = QLatin1Char(char('a' + c));
+      }
+    }
+
+    return result;
+  }
+
+  Item makeItem(Engine& engine, const Month& month, const GeneratorConfig& config)
+  {
+    std::uniform_int_distribution<int> project(1, config.projects);
+    std::uniform_int_distribution<int> quarters(0, 32); // [0,8] hours
+    std::bernoulli_distribution is_booked(0.4);
+
+    Item result(projectid_t(project(engine)), makeText(engine, config.activityLength));
+    for(int day = 0; day < month.days(); day++) {
+      if( month.isWeekend(day + 1)  ||  !is_booked(engine) ) {
+        continue;
+      }
+
+      result.hours.set(std::size_t(day), numhour_t::fromCenti(quarters(engine)*25));
+    }
+
+    return result;
+  }
+
+} // namespace priv
+
+////// Public ////////////////////////////////////////////////////////////////
+
+Context generateContext(const GeneratorConfig& config)
+{
+  priv::Engine engine(config.seed);
+
+  Context result;
+
+  // (1) Projects ////////////////////////////////////////////////////////////
+
+  for(int i = 0; i < config.projects; i++) {
+    Project project = result.makeProject(QStringLiteral("Project %1").arg(i + 1));
+    project.annotation = priv::makeText(engine, config.activityLength/2);
+
+    result.add(std::move(project));
+  }
+
+  // (2) Months //////////////////////////////////////////////////////////////
+
+  for(int year = priv::FIRST_YEAR; year < priv::FIRST_YEAR + config.years; year++) {
+    for(int m = 1; m <= 12; m++) {
+      Month month(year, m);
+      for(int i = 0; i < config.itemsPerMonth; i++) {
+        month.add(priv::makeItem(engine, month, config));
+      }
+
+      result.add(std::move(month));
+    } // Month
+  } // Year
+
+  result.clearModified();
+
+  return result;
+}
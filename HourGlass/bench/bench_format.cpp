@@ -0,0 +1,147 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <QtCore/QString>
+
+#include "Format.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  constexpr int NUM_VALUES = 1'000'000;
+  constexpr int NUM_RUNS   = 5;
+
+  using Clock = std::chrono::steady_clock;
+
+  // NOTE: Stores the checksums to defeat optimization.
+  volatile qsizetype sink = 0;
+
+  std::vector<numhour_t> makeValues()
+  {
+    std::mt19937 engine(2024);
+    std::uniform_int_distribution<int> centi(1, 2400); // (0,24] hours
+
+    std::vector<numhour_t> values;
+    values.reserve(NUM_VALUES);
+    for(int i = 0; i < NUM_VALUES; i++) {
+      values.push_back(numhour_t::fromCenti(centi(engine)));
+    }
+
+    return values;
+  }
+
+  // Exact round-trip of every 2-decimal value up to 1000 hours
+  bool verify()
+  {
+    QString text;
+    for(int centi = -100'000; centi <= 100'000; centi++) {
+      const numhour_t hours = numhour_t::fromCenti(centi);
+
+      Format::toString(text, hours);
+      if( text != QString::number(hours.toDouble(), 'f', 2) ) {
+        std::printf("MISMATCH: %s\n", qPrintable(text));
+        return false;
+      }
+
+      bool ok{false};
+      if( text.toDouble(&ok) != hours.toDouble()  ||  !ok ) {
+        std::printf("ROUND-TRIP: %s\n", qPrintable(text));
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  template<typename FUNC>
+  double measure(const std::vector<numhour_t>& values, FUNC&& func)
+  {
+    double best = 0;
+    for(int run = 0; run < NUM_RUNS; run++) {
+      const Clock::time_point start = Clock::now();
+
+      qsizetype sum = 0;
+      for(const numhour_t hours : values) {
+        sum += func(hours);
+      }
+      sink = sum;
+
+      const std::chrono::duration<double,std::nano> elapsed = Clock::now() - start;
+      const double ns = elapsed.count()/double(values.size());
+      if( run == 0  ||  ns < best ) {
+        best = ns;
+      }
+    }
+
+    return best;
+  }
+
+} // namespace priv
+
+////// Main //////////////////////////////////////////////////////////////////
+
+int main(int /*argc*/, char ** /*argv*/)
+{
+  if( !priv::verify() ) {
+    return EXIT_FAILURE;
+  }
+
+  const std::vector<numhour_t> values = priv::makeValues();
+
+  const double number = priv::measure(values, [](const numhour_t hours) -> qsizetype {
+    return QString::number(hours.toDouble(), 'f', 2).size();
+  });
+
+  QString text;
+  text.reserve(int(Format::HOURS_SIZE));
+  const double toString = priv::measure(values, [&](const numhour_t hours) -> qsizetype {
+    Format::toString(text, hours);
+    return text.size();
+  });
+
+  char chars[Format::HOURS_SIZE];
+  const double toChars = priv::measure(values, [&](const numhour_t hours) -> qsizetype {
+    return Format::toChars(chars, chars + Format::HOURS_SIZE, hours) - chars;
+  });
+
+  std::printf("QString::number()  : %7.1f ns/value\n", number);
+  std::printf("Format::toString() : %7.1f ns/value\n", toString);
+  std::printf("Format::toChars()  : %7.1f ns/value\n", toChars);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,139 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "File_io.h"
+#include "Report.h"
+
+#include "Benchmark.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  ////// Benchmarks //////////////////////////////////////////////////////////
+
+  Benchmarks makeBenchmarks(const Context& context, const QString& dir)
+  {
+    const QString xmlName = dir + QStringLiteral("/bench.xhours");
+    const QString zName   = dir + QStringLiteral("/bench.xhours.z");
+    const QString binName = dir + QStringLiteral("/bench.hgbin");
+
+    const MonthIDs months = context.listMonths();
+
+    // NOTE: Copies whose totals are invalidated on every run; i.e. the sums
+    //       are computed by the kernels instead of read from the cache.
+    std::vector<Month> copies;
+    copies.reserve(months.size());
+    for(const monthid_t id : months) {
+      copies.push_back(*context.findMonth(id));
+    }
+
+    // NOTE: Writing never caches fragments in the (const) context and the
+    //       generated context holds none; i.e. every run serializes all data.
+    auto lambda_save = [&context](const QString& filename) -> BenchmarkFunc
+    {
+      return [&context,filename]() -> qsizetype {
+        return writeHoursFile(filename, context) ? 1 : BENCHMARK_FAILED;
+      };
+    };
+
+    auto lambda_load = [](const QString& filename, const bool lazy) -> BenchmarkFunc
+    {
+      return [filename,lazy]() -> qsizetype {
+        Context loaded;
+        if( !readHoursFile(loaded, filename, nullptr, lazy) ) {
+          return BENCHMARK_FAILED;
+        }
+        return qsizetype(loaded.listMonths().size());
+      };
+    };
+
+    Benchmarks result;
+
+    result.push_back({QStringLiteral("save.xml"), lambda_save(xmlName)});
+    result.push_back({QStringLiteral("save.z"), lambda_save(zName)});
+    result.push_back({QStringLiteral("save.binary"), lambda_save(binName)});
+
+    result.push_back({QStringLiteral("load.xml"), lambda_load(xmlName, false)});
+    result.push_back({QStringLiteral("load.xml.lazy"), lambda_load(xmlName, true)});
+    result.push_back({QStringLiteral("load.z"), lambda_load(zName, false)});
+    result.push_back({QStringLiteral("load.binary"), lambda_load(binName, false)});
+
+    result.push_back({QStringLiteral("listMonths"), [&context]() -> qsizetype {
+                        return qsizetype(context.listMonths().size());
+                      }});
+
+    result.push_back({QStringLiteral("listProjects"), [&context]() -> qsizetype {
+                        return qsizetype(context.listProjects().size());
+                      }});
+
+    result.push_back({QStringLiteral("generateReport"), [&context,months]() -> qsizetype {
+                        qsizetype sum = 0;
+                        for(const monthid_t id : months) {
+                          sum += qsizetype(generateReport(*context.findMonth(id)).size());
+                        }
+                        return sum;
+                      }});
+
+    result.push_back({QStringLiteral("sumDayHours"), [copies]() mutable -> qsizetype {
+                        numhour_t sum{0};
+                        for(Month& month : copies) {
+                          month.invalidateTotals();
+                          for(std::size_t day = 0; day < std::size_t(month.days()); day++) {
+                            sum += month.sumDayHours(day);
+                          }
+                        }
+                        return qsizetype(sum.centi());
+                      }});
+
+    result.push_back({QStringLiteral("Month::sumHours"), [copies]() mutable -> qsizetype {
+                        numhour_t sum{0};
+                        for(Month& month : copies) {
+                          month.invalidateTotals();
+                          sum += month.sumHours();
+                        }
+                        return qsizetype(sum.centi());
+                      }});
+
+    return result;
+  }
+
+} // namespace priv
+
+////// Main //////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+  Context context;
+
+  return runBenchmarks(argc, argv, QStringLiteral("HourGlass' benchmark suite."),
+                       context, priv::makeBenchmarks);
+}
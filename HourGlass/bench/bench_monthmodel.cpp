@@ -0,0 +1,79 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "Global.h"
+#include "MonthModel.h"
+
+#include "Benchmark.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  ////// Benchmarks //////////////////////////////////////////////////////////
+
+  Benchmarks makeBenchmarks(const Context& context, const QString& /*dir*/)
+  {
+    const MonthIDs months = context.listMonths();
+
+    Benchmarks result;
+
+    result.push_back({QStringLiteral("MonthModel::data"), [&context,months]() -> qsizetype {
+                        MonthModel model;
+                        qsizetype sum = 0;
+                        for(const monthid_t id : months) {
+                          model.setMonth(context.findMonth(id));
+                          const int rows    = model.rowCount();
+                          const int columns = model.columnCount();
+                          for(int row = 0; row < rows; row++) {
+                            for(int column = 0; column < columns; column++) {
+                              const QModelIndex index = model.index(row, column);
+                              sum += model.data(index, Qt::DisplayRole).isValid() ? 1 : 0;
+                              sum += model.data(index, Qt::BackgroundRole).isValid() ? 1 : 0;
+                            }
+                          }
+                        }
+                        return sum;
+                      }});
+
+    return result;
+  }
+
+} // namespace priv
+
+////// Main //////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+  // NOTE: MonthModel resolves project names through the global context.
+  return runBenchmarks(argc, argv, QStringLiteral("HourGlass' MonthModel benchmark."),
+                       global, priv::makeBenchmarks);
+}
@@ -0,0 +1,550 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDate>
+#include <QtCore/QRunnable>
+#include <QtCore/QStringList>
+#include <QtCore/QThreadPool>
+
+#include "Context.h"
+#include "File_io.h"
+#include "Format.h"
+#include "IoError.h"
+#include "Report.h"
+
+#define TR_CTX  "hourglass-cli"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  enum ExitCode : int {
+    ExitSuccess = 0,
+    ExitInvalidFile,
+    ExitUsage
+  };
+
+  enum class OutputFormat {
+    Table = 0,
+    Csv,
+    Json
+  };
+
+  struct Selection {
+    MonthIDs         months;
+    std::vector<int> years;
+
+    bool isEmpty() const
+    {
+      return months.empty()  &&  years.empty();
+    }
+  };
+
+  struct ProjectRow {
+    projectid_t id{INVALID_PROJECTID};
+    QString     name;
+    QString     annotation;
+    numhour_t   hours{0};
+  };
+
+  struct MonthReport {
+    QString                 month;
+    std::vector<ProjectRow> projects;
+    numhour_t               sum{0};
+  };
+
+  struct FileReport {
+    QString                  filename;
+    IoError                  error;
+    std::vector<MonthReport> months;
+  };
+
+  using FileReports = std::vector<FileReport>;
+
+  ////// Load ////////////////////////////////////////////////////////////////
+
+  void loadReport(FileReport& report, const Selection& selection, const bool parallel)
+  {
+    Context context;
+    if( !readHoursFile(context, report.filename, &report.error, false, parallel) ) {
+      return;
+    }
+
+    MonthIDs ids = selection.isEmpty()
+        ? context.listMonths()
+        : selection.months;
+    for(const int year : selection.years) {
+      const MonthIDs months = context.listYear(year);
+      ids.insert(ids.end(), months.cbegin(), months.cend());
+    }
+
+    // NOTE: Listed newest first; reported oldest first.
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    for(const monthid_t id : ids) {
+      const Month *month = context.findMonth(id);
+      if( month == nullptr ) {
+        continue;
+      }
+
+      const Report entries = generateReport(*month);
+
+      MonthReport result;
+      result.month = month->toString();
+      result.projects.reserve(entries.size());
+      for(const ReportEntry& entry : entries) {
+        ProjectRow row;
+        row.id    = entry.first;
+        row.hours = entry.second;
+
+        const Project *project = context.findProject(entry.first);
+        if( project != nullptr ) {
+          row.name       = project->name;
+          row.annotation = project->annotation;
+        }
+
+        result.projects.push_back(std::move(row));
+      }
+      result.sum = sumReport(entries);
+
+      report.months.push_back(std::move(result));
+    } // Month
+  }
+
+  class LoadTask : public QRunnable {
+  public:
+    LoadTask(FileReport *report, const Selection *selection) noexcept
+      : _report{report}
+      , _selection{selection}
+    {
+    }
+
+    void run() final
+    {
+      // NOTE: The files are the unit of parallelism; cf. loadReports().
+      loadReport(*_report, *_selection, false);
+    }
+
+  private:
+    FileReport     *_report{nullptr};
+    const Selection *_selection{nullptr};
+  };
+
+  // NOTE: Every task owns exactly one FileReport; no locking required.
+  void loadReports(FileReports& reports, const Selection& selection, const int jobs)
+  {
+    // NOTE: A single file is parsed in parallel by the reader itself.
+    if( reports.size() == 1 ) {
+      loadReport(reports.front(), selection, true);
+      return;
+    }
+
+    QThreadPool pool;
+    if( jobs > 0 ) {
+      pool.setMaxThreadCount(jobs);
+    }
+
+    for(FileReport& report : reports) {
+      pool.start(new LoadTask(&report, &selection));
+    }
+
+    pool.waitForDone();
+  }
+
+  ////// Output //////////////////////////////////////////////////////////////
+
+  void appendHours(QByteArray& output, const numhour_t hours)
+  {
+    char buffer[Format::HOURS_SIZE];
+    const char *last = Format::toChars(buffer, buffer + Format::HOURS_SIZE, hours);
+    output.append(buffer, int(last - buffer));
+  }
+
+  QByteArray hoursString(const numhour_t hours)
+  {
+    QByteArray result;
+    appendHours(result, hours);
+    return result;
+  }
+
+  void writeCsvField(QByteArray& output, const QString& field)
+  {
+    const bool is_quoted = field.contains(QLatin1Char(','))  ||
+        field.contains(QLatin1Char('"'))  ||
+        field.contains(QLatin1Char('\n'))  ||
+        field.contains(QLatin1Char('\r'));
+
+    if( !is_quoted ) {
+      output.append(field.toUtf8());
+      return;
+    }
+
+    QString quoted(field);
+    quoted.replace(QLatin1Char('"'), QStringLiteral("\"\""));
+
+    output.append('"');
+    output.append(quoted.toUtf8());
+    output.append('"');
+  }
+
+  QByteArray toCsv(const FileReports& reports)
+  {
+    QByteArray output("file,month,id,name,annotation,hours\n");
+
+    for(const FileReport& file : reports) {
+      for(const MonthReport& month : file.months) {
+        for(const ProjectRow& project : month.projects) {
+          writeCsvField(output, file.filename);
+          output.append(',');
+          output.append(month.month.toUtf8());
+          output.append(',');
+          output.append(QByteArray::number(project.id));
+          output.append(',');
+          writeCsvField(output, project.name);
+          output.append(',');
+          writeCsvField(output, project.annotation);
+          output.append(',');
+          appendHours(output, project.hours);
+          output.append('\n');
+        } // Project
+      } // Month
+    } // File
+
+    return output;
+  }
+
+  void writeJsonString(QByteArray& output, const QString& string)
+  {
+    QString escaped;
+    escaped.reserve(string.size());
+    for(const QChar& ch : string) {
+      const char16_t c = ch.unicode();
+      if(        c == u'"' ) {
+        escaped += QStringLiteral("\\\"");
+      } else if( c == u'\\' ) {
+        escaped += QStringLiteral("\\\\");
+      } else if( c == u'\n' ) {
+        escaped += QStringLiteral("\\n");
+      } else if( c == u'\r' ) {
+        escaped += QStringLiteral("\\r");
+      } else if( c == u'\t' ) {
+        escaped += QStringLiteral("\\t");
+      } else if( c < 0x20 ) {
+        escaped += QStringLiteral("\\u%1").arg(int(c), 4, 16, QLatin1Char('0'));
+      } else {
+        escaped += ch;
+      }
+    }
+
+    output.append('"');
+    output.append(escaped.toUtf8());
+    output.append('"');
+  }
+
+  QByteArray toJson(const FileReports& reports)
+  {
+    QByteArray output("[");
+
+    bool is_first_file = true;
+    for(const FileReport& file : reports) {
+      if( !file.error.isError() ) {
+        output.append(is_first_file ? "\n" : ",\n");
+        is_first_file = false;
+
+        output.append("  {\"file\": ");
+        writeJsonString(output, file.filename);
+        output.append(", \"months\": [");
+
+        bool is_first_month = true;
+        for(const MonthReport& month : file.months) {
+          output.append(is_first_month ? "\n" : ",\n");
+          is_first_month = false;
+
+          output.append("    {\"month\": ");
+          writeJsonString(output, month.month);
+          output.append(", \"sum\": ");
+          appendHours(output, month.sum);
+          output.append(", \"projects\": [");
+
+          bool is_first_project = true;
+          for(const ProjectRow& project : month.projects) {
+            output.append(is_first_project ? "\n" : ",\n");
+            is_first_project = false;
+
+            output.append("      {\"id\": ");
+            output.append(QByteArray::number(project.id));
+            output.append(", \"name\": ");
+            writeJsonString(output, project.name);
+            output.append(", \"annotation\": ");
+            writeJsonString(output, project.annotation);
+            output.append(", \"hours\": ");
+            appendHours(output, project.hours);
+            output.append("}");
+          } // Project
+
+          output.append(is_first_project ? "]}" : "\n    ]}");
+        } // Month
+
+        output.append(is_first_month ? "]}" : "\n  ]}");
+      }
+    } // File
+
+    output.append(is_first_file ? "]\n" : "\n]\n");
+
+    return output;
+  }
+
+  QByteArray toTable(const FileReports& reports)
+  {
+    using Row = std::vector<QString>;
+
+    const Row header{
+      QStringLiteral("File"), QStringLiteral("Month"), QStringLiteral("ID"),
+          QStringLiteral("Name"), QStringLiteral("Annotation"), QStringLiteral("Hours")
+    };
+    const std::size_t NUM_COLUMNS = header.size();
+    const std::size_t COL_HOURS   = NUM_COLUMNS - 1;
+
+    // (1) Gather rows ///////////////////////////////////////////////////////
+
+    std::vector<Row> rows;
+    rows.push_back(header);
+    for(const FileReport& file : reports) {
+      for(const MonthReport& month : file.months) {
+        for(const ProjectRow& project : month.projects) {
+          rows.push_back(Row{file.filename, month.month, QString::number(project.id),
+                             project.name, project.annotation,
+                             QString::fromLatin1(hoursString(project.hours))});
+        }
+
+        rows.push_back(Row{file.filename, month.month, QString(),
+                           QString(), QCoreApplication::translate(TR_CTX, "Sum"),
+                           QString::fromLatin1(hoursString(month.sum))});
+      } // Month
+    } // File
+
+    // (2) Column widths /////////////////////////////////////////////////////
+
+    std::vector<int> widths(NUM_COLUMNS, 0);
+    for(const Row& row : rows) {
+      for(std::size_t col = 0; col < NUM_COLUMNS; col++) {
+        widths[col] = std::max<int>(widths[col], row[col].size());
+      }
+    }
+
+    // (3) Output ////////////////////////////////////////////////////////////
+
+    QByteArray output;
+    for(const Row& row : rows) {
+      QString line;
+      for(std::size_t col = 0; col < NUM_COLUMNS; col++) {
+        if( col > 0 ) {
+          line += QStringLiteral("  ");
+        }
+
+        line += col == COL_HOURS
+            ? row[col].rightJustified(widths[col])
+            : row[col].leftJustified(widths[col]);
+      }
+
+      output.append(line.toUtf8());
+      output.append('\n');
+    } // Row
+
+    return output;
+  }
+
+  ////// Command Line ////////////////////////////////////////////////////////
+
+  bool parseFormat(OutputFormat& format, const QString& value)
+  {
+    if(        value == QStringLiteral("table") ) {
+      format = OutputFormat::Table;
+    } else if( value == QStringLiteral("csv") ) {
+      format = OutputFormat::Csv;
+    } else if( value == QStringLiteral("json") ) {
+      format = OutputFormat::Json;
+    } else {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool parseMonths(MonthIDs& months, const QStringList& values)
+  {
+    for(const QString& value : values) {
+      const QDate date = QDate::fromString(value, QStringLiteral("yyyy-MM"));
+      if( !date.isValid() ) {
+        return false;
+      }
+
+      months.push_back(make_monthid(date.year(), date.month()));
+    }
+
+    return true;
+  }
+
+  bool parseYears(std::vector<int>& years, const QStringList& values)
+  {
+    for(const QString& value : values) {
+      const QDate date = QDate::fromString(value, QStringLiteral("yyyy"));
+      if( !date.isValid() ) {
+        return false;
+      }
+
+      years.push_back(date.year());
+    }
+
+    return true;
+  }
+
+  void printError(const QString& message)
+  {
+    std::fprintf(stderr, "%s\n", message.toLocal8Bit().constData());
+  }
+
+} // namespace priv
+
+////// Main //////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+  QCoreApplication app(argc, argv);
+  app.setOrganizationName(QStringLiteral("csLabs"));
+  app.setApplicationName(QStringLiteral("hourglass-cli"));
+
+  // (1) Command Line ////////////////////////////////////////////////////////
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(QCoreApplication::translate(TR_CTX,
+                                                               "Per-project monthly totals of HourGlass files."));
+  parser.addHelpOption();
+
+  const QCommandLineOption formatOption(QStringList{QStringLiteral("f"), QStringLiteral("format")},
+                                        QCoreApplication::translate(TR_CTX, "Output format: table (default), csv or json."),
+                                        QStringLiteral("format"), QStringLiteral("table"));
+  parser.addOption(formatOption);
+
+  const QCommandLineOption jobsOption(QStringList{QStringLiteral("j"), QStringLiteral("jobs")},
+                                      QCoreApplication::translate(TR_CTX, "Number of files loaded in parallel (default: all cores)."),
+                                      QStringLiteral("jobs"));
+  parser.addOption(jobsOption);
+
+  const QCommandLineOption monthOption(QStringList{QStringLiteral("m"), QStringLiteral("month")},
+                                       QCoreApplication::translate(TR_CTX, "Only report month <yyyy-MM>; may be repeated."),
+                                       QStringLiteral("yyyy-MM"));
+  parser.addOption(monthOption);
+
+  const QCommandLineOption yearOption(QStringList{QStringLiteral("y"), QStringLiteral("year")},
+                                      QCoreApplication::translate(TR_CTX, "Only report the months of year <yyyy>; may be repeated."),
+                                      QStringLiteral("yyyy"));
+  parser.addOption(yearOption);
+
+  parser.addPositionalArgument(QStringLiteral("files"),
+                               QCoreApplication::translate(TR_CTX, "HourGlass files to report."),
+                               QStringLiteral("files..."));
+
+  parser.process(app);
+
+  priv::OutputFormat format = priv::OutputFormat::Table;
+  if( !priv::parseFormat(format, parser.value(formatOption)) ) {
+    priv::printError(QCoreApplication::translate(TR_CTX, "Invalid format \"%1\"!")
+                     .arg(parser.value(formatOption)));
+    return priv::ExitUsage;
+  }
+
+  int jobs = 0;
+  if( parser.isSet(jobsOption) ) {
+    bool ok = false;
+    jobs = parser.value(jobsOption).toInt(&ok);
+    if( !ok  ||  jobs < 1 ) {
+      priv::printError(QCoreApplication::translate(TR_CTX, "Invalid number of jobs \"%1\"!")
+                       .arg(parser.value(jobsOption)));
+      return priv::ExitUsage;
+    }
+  }
+
+  priv::Selection selection;
+  if( !priv::parseMonths(selection.months, parser.values(monthOption)) ) {
+    priv::printError(QCoreApplication::translate(TR_CTX, "Invalid month! Expected <yyyy-MM>."));
+    return priv::ExitUsage;
+  }
+  if( !priv::parseYears(selection.years, parser.values(yearOption)) ) {
+    priv::printError(QCoreApplication::translate(TR_CTX, "Invalid year! Expected <yyyy>."));
+    return priv::ExitUsage;
+  }
+
+  const QStringList filenames = parser.positionalArguments();
+  if( filenames.isEmpty() ) {
+    parser.showHelp(priv::ExitUsage);
+  }
+
+  // (2) Load ////////////////////////////////////////////////////////////////
+
+  priv::FileReports reports(std::size_t(filenames.size()));
+  for(int i = 0; i < filenames.size(); i++) {
+    reports[std::size_t(i)].filename = filenames[i];
+  }
+
+  priv::loadReports(reports, selection, jobs);
+
+  int result = priv::ExitSuccess;
+  for(const priv::FileReport& report : reports) {
+    if( report.error.isError() ) {
+      priv::printError(report.error.toString());
+      result = priv::ExitInvalidFile;
+    }
+  }
+
+  // (3) Output //////////////////////////////////////////////////////////////
+
+  QByteArray output;
+  if(        format == priv::OutputFormat::Csv ) {
+    output = priv::toCsv(reports);
+  } else if( format == priv::OutputFormat::Json ) {
+    output = priv::toJson(reports);
+  } else {
+    output = priv::toTable(reports);
+  }
+
+  std::fwrite(output.constData(), 1, std::size_t(output.size()), stdout);
+  std::fflush(stdout);
+
+  return result;
+}
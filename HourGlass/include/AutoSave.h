@@ -0,0 +1,87 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <memory>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+
+class QLockFile;
+class QTimer;
+
+class HoursWriter;
+
+// Writes the global Context to a recovery file, once a burst of
+// modifications has settled; cf. notify(). Every instance owns a locked
+// slot of recovery files, preferring the one left behind by a crash.
+class AutoSave : public QObject {
+  Q_OBJECT
+public:
+  AutoSave(QObject *parent = nullptr);
+  ~AutoSave();
+
+  int delay() const;
+  void setDelay(const int ms);
+
+  bool isEnabled() const;
+
+  bool hasRecovery() const;
+  QString recoveryFilename() const;
+  QString recoverySource() const;
+  // NOTE: Deferred until a running write has finished.
+  void removeRecovery();
+
+public slots:
+  void notify();
+  void setEnabled(const bool on);
+  void setSource(const QString& filename);
+
+private slots:
+  void write();
+  void writeFinished(const QString& filename, const bool ok);
+
+private:
+  void acquireSlot();
+  QString slotFilename(const QString& suffix) const;
+
+  int _delay{0};
+  QElapsedTimer _elapsed;
+  bool _is_enabled{false};
+  bool _is_pending{false};
+  bool _is_remove_pending{false};
+  std::unique_ptr<QLockFile> _lock;
+  int _slot{-1};
+  QString _source;
+  QTimer *_timer{nullptr};
+  HoursWriter *_writer{nullptr};
+};
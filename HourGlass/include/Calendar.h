@@ -0,0 +1,144 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Gregorian calendar arithmetic; valid for year >= 1.
+namespace Calendar {
+
+  constexpr int MAX_DAYS = 31;
+
+  struct Day {
+    std::uint8_t weekDay{0}; // ISO 8601, i.e. 1 := Monday, ..., 7 := Sunday
+    std::uint8_t week{0};    // ISO 8601
+    bool         is_weekend{false};
+  };
+
+  struct Table {
+    int                      days{0};
+    std::array<Day,MAX_DAYS> day{};
+  };
+
+  constexpr bool isLeapYear(const int year)
+  {
+    return (year % 4 == 0  &&  year % 100 != 0)  ||  year % 400 == 0;
+  }
+
+  constexpr int daysInMonth(const int year, const int month)
+  {
+    constexpr std::array<int,12> DAYS{31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+    if( year < 1  ||  month < 1  ||  month > 12 ) {
+      return 0;
+    }
+
+    return month == 2  &&  isLeapYear(year)
+        ? 29
+        : DAYS[month - 1];
+  }
+
+  constexpr int dayOfYear(const int year, const int month, const int day)
+  {
+    int result = day;
+    for(int m = 1; m < month; m++) {
+      result += daysInMonth(year, m);
+    }
+
+    return result;
+  }
+
+  // ISO 8601, i.e. 1 := Monday, ..., 7 := Sunday
+  constexpr int dayOfWeek(int year, const int month, const int day)
+  {
+    constexpr std::array<int,12> OFFSET{0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4};
+
+    if( month < 3 ) {
+      year -= 1;
+    }
+
+    const int result = (year + year/4 - year/100 + year/400 + OFFSET[month - 1] + day) % 7;
+
+    return result == 0 // Sunday
+        ? 7
+        : result;
+  }
+
+  constexpr int weeksInYear(const int year)
+  {
+    auto lambda_p = [](const int y) -> int {
+      return (y + y/4 - y/100 + y/400) % 7;
+    };
+
+    return lambda_p(year) == 4  ||  lambda_p(year - 1) == 3
+        ? 53
+        : 52;
+  }
+
+  // ISO 8601
+  constexpr int weekNumber(const int year, const int month, const int day)
+  {
+    const int week = (dayOfYear(year, month, day) - dayOfWeek(year, month, day) + 10)/7;
+
+    if(        week < 1 ) {
+      return weeksInYear(year - 1);
+    } else if( week > weeksInYear(year) ) {
+      return 1;
+    }
+
+    return week;
+  }
+
+  constexpr Table makeTable(const int year, const int month)
+  {
+    Table result;
+
+    result.days = daysInMonth(year, month);
+    for(int i = 0; i < result.days; i++) {
+      const int weekDay = dayOfWeek(year, month, i + 1);
+
+      result.day[std::size_t(i)].weekDay    = std::uint8_t(weekDay);
+      result.day[std::size_t(i)].week       = std::uint8_t(weekNumber(year, month, i + 1));
+      result.day[std::size_t(i)].is_weekend = weekDay >= 6;
+    }
+
+    return result;
+  }
+
+  static_assert( dayOfWeek(2024, 1, 1) == 1 );
+  static_assert( weekNumber(2021, 1, 1) == 53 );
+  static_assert( weekNumber(2024, 12, 30) == 1 );
+  static_assert( makeTable(2024, 2).days == 29 );
+
+} // namespace Calendar
@@ -31,9 +31,27 @@
 
 #pragma once
 
+#include <functional>
+
+#include <QtCore/QByteArray>
+
 #include "Month.h"
 
+struct IoError;
+
+// Serialized XML elements of unmodified resp. lazily loaded months & projects
+using MonthFragments   = std::map<monthord_t,QByteArray>;
+using ProjectFragments = std::unordered_map<projectid_t,QByteArray>;
+
+// Fragments serialized by a write; cf. Context::cacheFragments().
+struct XmlFragments {
+  MonthFragments   months;
+  ProjectFragments projects;
+};
+
 struct Context {
+  using ModifiedHandler = std::function<void()>;
+
   Context() noexcept;
 
   bool isValid() const;
@@ -44,28 +62,81 @@ struct Context {
   }
 
   void clear();
+  // NOTE: Copies only the modified months; an unmodified month is represented
+  //       by its (implicitly shared) fragment, i.e. it is parsed on demand.
+  Context snapshot() const;
 
   void clearModified();
   bool isModified() const;
+  // Incremented by every modification; cf. setModified().
+  std::size_t revision() const;
   void setModified();
+  void setModifiedHandler(ModifiedHandler handler);
 
   bool add(Month m);
-  Month *findMonth(const monthid_t id) const;
+  bool add(const monthid_t id, QByteArray fragment);
+  // NOTE: Lazily loaded months are parsed and validated on first access;
+  //       "error" is optional and reports why such a month failed to load.
+  Month *findMonth(const monthid_t id, IoError *error = nullptr) const;
   bool isMonth(const monthid_t id) const;
+  bool isMonthModified(const monthid_t id) const;
+  // NOTE: Like findMonth(), but a lazily loaded month is parsed into "buffer"
+  //       instead of being cached; i.e. the context is left unchanged.
+  const Month *viewMonth(const monthid_t id, Month& buffer, IoError *error = nullptr) const;
+  // Newest first; "first" & "last" are inclusive.
   MonthIDs listMonths() const;
+  MonthIDs listMonths(const monthid_t first, const monthid_t last) const;
+  // quarter := [1,4]
+  MonthIDs listQuarter(const int year, const int quarter) const;
+  MonthIDs listYear(const int year) const;
   void set(MonthDB months);
+  void setMonthModified(const monthid_t id);
 
   bool add(Project p);
   Project *findProject(const projectid_t id) const;
   bool isProject(const projectid_t id) const;
+  bool isProjectModified(const projectid_t id) const;
   ProjectIDs listProjects() const;
+  // NOTE: Valid until the next modification of the projects.
+  const ProjectIDs& listProjectsByName() const;
   Project makeProject(const QString& name) const;
   void set(ProjectDB projects);
+  void setProjectModified(const projectid_t id);
+
+  // NOTE: "fragments" are required to be serialized from the current revision!
+  void cacheFragments(XmlFragments fragments);
+  void cacheMonthFragment(const monthid_t id, QByteArray fragment);
+  void cacheProjectFragment(const projectid_t id, QByteArray fragment);
+  QByteArray monthFragment(const monthid_t id) const;
+  QByteArray projectFragment(const projectid_t id) const;
 
 private:
+  // NOTE: The handler is bound to its instance, i.e. it is neither copied nor moved.
+  struct Handler {
+    Handler() noexcept = default;
+
+    Handler(const Handler&) noexcept
+    {
+    }
+
+    Handler& operator=(const Handler&) noexcept
+    {
+      return *this;
+    }
+
+    ModifiedHandler func;
+  };
+
+  MonthIDs listRange(const monthord_t first, const monthord_t last) const;
+  Month *loadMonth(const monthid_t id, IoError *error) const;
+  bool parseMonth(Month& month, const monthid_t id, IoError *error) const;
+
   bool _is_modified{false};
-  MonthDB _months;
+  std::size_t _revision{0};
+  Handler _modifiedHandler;
+  // NOTE: Lazily loaded months are parsed on first access, even if const.
+  mutable MonthDB _months;
+  MonthFragments _monthFragments;
   ProjectDB _projects;
-
-  friend class WMainWindow;
+  ProjectFragments _projectFragments;
 };
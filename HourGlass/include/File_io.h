@@ -32,10 +32,15 @@
 #pragma once
 
 struct Context;
+struct IoError;
+struct XmlFragments;
 class QString;
-class QWidget;
 
-bool backupHoursFile(const QString& filename);
-
-bool readHoursFile(Context& context, const QString& filename, QWidget *parent);
-bool writeHoursFile(const QString& filename, const Context& context, QWidget *parent);
+// NOTE: Neither function interacts with the user; cf. IoError.
+// NOTE: Callers reading several files concurrently should disable "parallel".
+bool readHoursFile(Context& context, const QString& filename, IoError *error = nullptr,
+                   const bool lazy = false, const bool parallel = true);
+// NOTE: "fragments" is optional and receives the XML elements serialized by a
+//       successful write; cf. Context::cacheFragments().
+bool writeHoursFile(const QString& filename, const Context& context, IoError *error = nullptr,
+                    XmlFragments *fragments = nullptr);
@@ -32,5 +32,7 @@
 #pragma once
 
 #include "Context.h"
+#include "Journal.h"
 
 extern Context global;
+extern Journal journal;
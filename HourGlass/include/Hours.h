@@ -32,7 +32,152 @@
 #pragma once
 
 #include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 
-using Hours = std::array<double,31>;
+// Fixed-point hours in centi-hours, i.e. sums are exact.
+class numhour_t {
+public:
+  using value_type = std::int32_t;
 
-using numhour_t = Hours::value_type;
+  static constexpr value_type SCALE = 100;
+
+  constexpr numhour_t() noexcept = default;
+
+  constexpr explicit numhour_t(const int hours) noexcept
+    : _centi{hours*SCALE}
+  {
+  }
+
+  numhour_t(const double) = delete; // cf. fromDouble()
+
+  static constexpr numhour_t fromCenti(const value_type centi) noexcept
+  {
+    numhour_t result;
+    result._centi = centi;
+    return result;
+  }
+
+  // Rounds to the nearest centi-hour; fails on NaN, infinity resp. overflow.
+  static bool fromDouble(numhour_t& result, const double hours);
+
+  constexpr value_type centi() const noexcept
+  {
+    return _centi;
+  }
+
+  constexpr double toDouble() const noexcept
+  {
+    return double(_centi)/double(SCALE);
+  }
+
+  constexpr numhour_t& operator+=(const numhour_t& other) noexcept
+  {
+    _centi += other._centi;
+    return *this;
+  }
+
+  constexpr numhour_t& operator-=(const numhour_t& other) noexcept
+  {
+    _centi -= other._centi;
+    return *this;
+  }
+
+  constexpr numhour_t operator-() const noexcept
+  {
+    return fromCenti(-_centi);
+  }
+
+  friend constexpr numhour_t operator+(numhour_t lhs, const numhour_t& rhs) noexcept
+  {
+    return lhs += rhs;
+  }
+
+  friend constexpr numhour_t operator-(numhour_t lhs, const numhour_t& rhs) noexcept
+  {
+    return lhs -= rhs;
+  }
+
+  friend constexpr bool operator==(const numhour_t&, const numhour_t&) noexcept = default;
+  friend constexpr auto operator<=>(const numhour_t&, const numhour_t&) noexcept = default;
+
+private:
+  value_type _centi{0};
+};
+
+static_assert( sizeof(numhour_t) == sizeof(numhour_t::value_type) );
+
+constexpr std::size_t NUM_DAYS = 31;
+
+using HoursArray = std::array<numhour_t,NUM_DAYS>;
+
+// Kernels; vectorized where available.
+void addHours(HoursArray& sum, const HoursArray& hours);
+numhour_t sumHours(const HoursArray& hours);
+
+// A month's hours per day := [0,30]; a few booked days are kept sparse
+// (bitmap & packed values), more turn the storage dense.
+class Hours {
+public:
+  // Booked days held without allocation
+  static constexpr std::size_t SPARSE_SIZE = 4;
+
+  Hours() noexcept = default;
+  explicit Hours(const HoursArray& hours);
+  ~Hours() noexcept = default;
+
+  Hours(const Hours& other);
+  Hours& operator=(const Hours& other);
+
+  Hours(Hours&&) noexcept = default;
+  Hours& operator=(Hours&&) noexcept = default;
+
+  static constexpr std::size_t size() noexcept
+  {
+    return NUM_DAYS;
+  }
+
+  numhour_t operator[](const std::size_t day) const;
+
+  bool isDense() const;
+  bool isEmpty() const;
+  void set(const std::size_t day, const numhour_t hours);
+
+  void addTo(HoursArray& sum) const;
+  numhour_t sum() const;
+  HoursArray toArray() const;
+
+  // Calls func(day, hours) for each booked day in ascending order.
+  template<typename FUNC>
+  void forEachDay(FUNC&& func) const
+  {
+    if( _dense ) {
+      for(std::size_t day = 0; day < NUM_DAYS; day++) {
+        if( (*_dense)[day] != numhour_t{0} ) {
+          func(day, (*_dense)[day]);
+        }
+      }
+      return;
+    }
+
+    std::uint32_t mask = _mask;
+    for(std::size_t i = 0; mask != 0; i++) {
+      func(std::size_t(std::countr_zero(mask)), _values[i]);
+      mask &= mask - 1;
+    }
+  }
+
+  friend bool operator==(const Hours& lhs, const Hours& rhs);
+
+private:
+  std::size_t index(const std::size_t day) const;
+  void makeDense();
+
+  // Sparse: bit "day" is set for each booked day; values in order of days.
+  std::uint32_t                     _mask{0};
+  std::array<numhour_t,SPARSE_SIZE> _values{};
+  std::unique_ptr<HoursArray>       _dense;
+};
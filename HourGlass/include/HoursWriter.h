@@ -0,0 +1,70 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QThreadPool>
+
+#include "Context.h"
+#include "IoError.h"
+
+// Writes a snapshot of a Context on a worker thread; cf. finished().
+class HoursWriter : public QObject {
+  Q_OBJECT
+public:
+  HoursWriter(QObject *parent = nullptr);
+  ~HoursWriter();
+
+  // NOTE: The error is only valid after the write has finished.
+  const IoError& error() const;
+  // XML elements serialized by the finished write; cf. Context::cacheFragments().
+  XmlFragments takeFragments();
+  bool isRunning() const;
+  // NOTE: The snapshot is only valid after the write has finished.
+  const Context& snapshot() const;
+  bool start(const QString& filename, const Context& context, const bool backup = false);
+  // Blocks until the running write has finished and emits finished().
+  void wait();
+
+private slots:
+  void finishWrite(const QString& filename, const bool ok);
+
+private:
+  QThreadPool _pool;
+  IoError _error;
+  XmlFragments _fragments;
+  bool _is_running{false};
+  Context _snapshot;
+
+signals:
+  void finished(const QString& filename, const bool ok);
+};
@@ -0,0 +1,89 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <functional>
+
+#include <QtCore/QFile>
+
+#include "Month.h"
+
+struct Context;
+
+// Append-only log of edits applied on top of the Hours file "filename";
+// cf. Journal::replay().
+class Journal {
+public:
+  // Called once a record could not be written; the journal is closed then.
+  using FailureHandler = std::function<void(const QString& errorString)>;
+
+  Journal() noexcept;
+  ~Journal();
+
+  bool isEmpty() const;
+  bool isOpen() const;
+  qint64 size() const;
+
+  void close();
+  bool open(const QString& filename);
+  void setFailureHandler(FailureHandler handler);
+
+  bool clear();
+  // Remove the records up to the journal's previous size "size".
+  bool discard(const qint64 size);
+  // Move the journal, replacing any journal of the Hours file "filename".
+  bool moveTo(const QString& filename);
+
+  void addItem(const monthid_t mid, const std::size_t row, const projectid_t pid);
+  void addMonth(const monthid_t mid);
+  void addProject(const Project& project);
+  void setActivity(const monthid_t mid, const std::size_t row, const QString& activity);
+  void setHours(const monthid_t mid, const std::size_t row, const std::size_t day,
+                const numhour_t hours);
+  void setItemProject(const monthid_t mid, const std::size_t row, const projectid_t pid);
+  void setProjectAnnotation(const projectid_t pid, const QString& annotation);
+  void setProjectName(const projectid_t pid, const QString& name);
+
+  static QString journalName(const QString& filename);
+  // Returns the number of records applied to "context".
+  static std::size_t replay(Context& context, const QString& filename);
+
+private:
+  Journal(const Journal&) = delete;
+  Journal& operator=(const Journal&) = delete;
+
+  void append(const QByteArray& record);
+  bool rewrite(const QByteArray& records);
+
+  QFile _file;
+  FailureHandler _failureHandler;
+};
@@ -31,8 +31,11 @@
 
 #pragma once
 
+#include <map>
+
 #include <QtCore/QString>
 
+#include "Calendar.h"
 #include "Item.h"
 
 class QDate;
@@ -56,24 +59,53 @@ struct Month {
 
   bool add(Item i);
   int days() const;
-  bool isCurrentDay(const int day) const;
   bool isMonday(const int day) const;
   bool isMonth(const QDate& date) const;
   bool isWeekend(const int day) const;
+  // day := [0,30]; updates the totals in O(1)
+  void setHours(const std::size_t row, const std::size_t day, const numhour_t hours);
   // day := [0,30]
   numhour_t sumDayHours(const std::size_t day) const;
+  HoursArray sumDayHours() const;
+  numhour_t sumHours() const;
+  numhour_t sumItemHours(const std::size_t row) const;
   QString toLocaleString() const;
   QString toString() const;
   int weekNumber(const int day) const;
 
+  // NOTE: Call after modifying "items"' hours directly; cf. setHours().
+  void invalidateTotals();
+  // Compares the cached totals to freshly computed ones.
+  bool isTotalsValid() const;
+
   Items items;
 
 private:
+  struct Totals {
+    bool                   is_valid{false};
+    HoursArray             days;
+    std::vector<numhour_t> items;
+    numhour_t              month;
+  };
+
+  // day := [1,31]
+  const Calendar::Day& calendarDay(const int day) const;
+  static Totals computeTotals(const Items& items);
+  const Totals& totals() const;
+
   int _month{0};
   int _year{0};
+  // NOTE: Built once; painting needs no date arithmetic.
+  Calendar::Table _calendar;
+  // NOTE: Built on first access, even if const.
+  mutable Totals _totals;
 };
 
-using MonthDB = std::unordered_map<monthid_t,Month>;
+// Dense & ordered in time: year*12 + month - 1
+using monthord_t = int;
+
+// Ordered in time; keyed by monthord_t.
+using MonthDB = std::map<monthord_t,Month>;
 
 using MonthIDs = std::vector<monthid_t>;
 
@@ -82,3 +114,6 @@ monthid_t make_monthid(const int year, const int month);
 using SplitId = std::pair<int,int>;
 
 SplitId split_monthid(const monthid_t id);
+
+monthord_t to_monthord(const monthid_t id);
+monthid_t from_monthord(const monthord_t ord);
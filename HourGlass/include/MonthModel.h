@@ -35,6 +35,8 @@
 
 #include "Project.h"
 
+class QTimer;
+
 struct Month;
 
 class MonthModel : public QAbstractTableModel {
@@ -74,14 +76,20 @@ public:
 public slots:
   void setShowProjectRow(const bool on);
 
+private slots:
+  void updateCurrentDay();
+
 private:
   using size_type = std::size_t;
 
   bool isDayHoursRow(const int row) const;
   bool isItemRow(const int row) const;
+  void startMidnightTimer();
 
   Month *_month{nullptr};
+  int    _currentDay{0}; // 0 := not the current month
   bool   _showProjectRow{false};
+  QTimer *_midnightTimer{nullptr};
 
 signals:
   void monthChanged(const QString&);
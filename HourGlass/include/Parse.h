@@ -0,0 +1,81 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QChar>
+
+#include "Hours.h"
+
+namespace Parse {
+
+  // Longest accepted number, after trimming whitespace
+  constexpr int MAX_LENGTH = 128;
+
+  // NOTE: Semantics of QString::toInt() et al.: [first,last) must hold the
+  //       number only, apart from surrounding whitespace and a leading '+'.
+  bool toValue(const char *first, const char *last, int& value);
+  bool toValue(const char *first, const char *last, unsigned int& value);
+  bool toValue(const char *first, const char *last, unsigned long& value);
+  bool toValue(const char *first, const char *last, unsigned long long& value);
+  bool toValue(const char *first, const char *last, double& value);
+  // NOTE: Rounds to the nearest centi-hour; cf. numhour_t::fromDouble().
+  bool toValue(const char *first, const char *last, numhour_t& value);
+
+  // NOTE: Narrows [first,last) on the stack; non-ASCII is rejected.
+  template<typename T>
+  inline bool toValue(const QChar *first, const QChar *last, T& value)
+  {
+    while( first != last  &&  first->isSpace() ) {
+      ++first;
+    }
+    while( last != first  &&  (last - 1)->isSpace() ) {
+      --last;
+    }
+
+    if( last - first > MAX_LENGTH ) {
+      return false;
+    }
+
+    char buffer[MAX_LENGTH];
+    char *p = buffer;
+    for(; first != last; ++first) {
+      const ushort ch = first->unicode();
+      if( ch >= 0x80 ) {
+        return false;
+      }
+      *p++ = char(ch);
+    }
+
+    return toValue(buffer, p, value);
+  }
+
+} // namespace Parse
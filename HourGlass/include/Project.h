@@ -31,6 +31,7 @@
 
 #pragma once
 
+#include <limits>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
@@ -62,6 +63,40 @@ private:
   projectid_t _id{INVALID_PROJECTID};
 };
 
-using ProjectDB = std::unordered_map<projectid_t,Project>;
-
 using ProjectIDs = std::vector<projectid_t>;
+
+// Projects indexed by their ID; holes of sparse IDs are invalid projects,
+// IDs far beyond the table are kept aside.
+class ProjectDB {
+public:
+  using size_type = std::size_t;
+
+  ProjectDB() noexcept = default;
+
+  bool add(Project p);
+  void clear();
+  bool contains(const projectid_t id) const;
+  bool empty() const;
+  Project *find(const projectid_t id);
+  const Project *find(const projectid_t id) const;
+  // Ascending
+  ProjectIDs ids() const;
+  // INVALID_PROJECTID if empty
+  projectid_t maxId() const;
+  size_type size() const;
+
+  // Sorted by name, case-insensitive; ties by ID.
+  const ProjectIDs& nameIndex() const;
+  // NOTE: Required after renaming a project found by find().
+  void invalidateNameIndex();
+
+private:
+  void grow(const size_type size);
+  bool isDenseId(const projectid_t id) const;
+
+  std::vector<Project>                    _table;
+  std::unordered_map<projectid_t,Project> _sparse;
+  size_type                               _count{0};
+  mutable ProjectIDs                      _names;
+  mutable bool                            _is_names_valid{false};
+};
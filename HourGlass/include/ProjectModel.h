@@ -50,6 +50,7 @@ public:
 
   void addProject(const QString& name);
   void clearProjects();
+  void resetProjects();
   void setProjects(ProjectDB projects);
 
   int columnCount(const QModelIndex& index) const;
@@ -31,14 +31,9 @@
 
 #pragma once
 
-#include <vector>
-
 #include <QtCore/QAbstractTableModel>
 
-#include "Month.h"
-
-using ReportEntry = std::pair<projectid_t,numhour_t>;
-using Report      = std::vector<ReportEntry>;
+#include "Report.h"
 
 class ReportModel : public QAbstractTableModel {
   Q_OBJECT
@@ -31,11 +31,17 @@
 
 #pragma once
 
+#include "Hours.h"
+
+struct IoError;
 class QString;
+class QWidget;
 
 namespace View {
 
-  double toDouble(const QString& hours);
-  QString toString(const double hours, const bool no_zero = false);
+  void showError(QWidget *parent, const IoError& error);
+  // NOTE: Blank text yields zero hours; cf. numhour_t::fromDouble().
+  bool toHours(numhour_t& hours, const QString& text);
+  QString toString(const numhour_t hours, const bool no_zero = false);
 
 } // namespace View
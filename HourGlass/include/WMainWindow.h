@@ -37,6 +37,12 @@ namespace Ui {
   class WMainWindow;
 } // namespace Ui
 
+class QCloseEvent;
+class QTimer;
+
+class AutoSave;
+struct Context;
+class HoursWriter;
 class RecentFiles;
 
 class WMainWindow : public QMainWindow {
@@ -45,15 +51,28 @@ public:
   WMainWindow(QWidget *parent = nullptr, Qt::WindowFlags flags = Qt::WindowFlags());
   ~WMainWindow();
 
+  void recover();
+
+protected:
+  void closeEvent(QCloseEvent *event) override;
+
 private slots:
+  void compactJournal();
   void open();
+  void openBackup();
   void openFile(const QString& filename);
   void quit();
   void save();
   void saveAs();
+  void setJournaling(const bool on);
+  void writeFinished(const QString& filename, const bool ok);
 
 private:
   QString getFilename(const bool is_save = false);
+  void openJournal(const QString& filename);
+  void resetContext(Context context);
+  void saveFile(const QString& filename);
+  void startWrite(const QString& filename, const bool is_save);
   void loadSettings();
   void saveSettings();
 
@@ -61,4 +80,12 @@ private:
 
   QString _lastfilename;
   RecentFiles *_recent{nullptr};
+
+  AutoSave *_autoSave{nullptr};
+
+  HoursWriter *_writer{nullptr};
+  bool _is_save_pending{false};
+  bool _is_saving{false};
+  qint64 _writeJournalSize{0};
+  QTimer *_compactTimer{nullptr};
 };
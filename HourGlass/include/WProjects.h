@@ -48,7 +48,7 @@ public:
   ~WProjects();
 
   void clear();
-  void initializeUi(ProjectDB projects);
+  void initializeUi();
 
   ProjectModel *model() const;
 
@@ -49,7 +49,7 @@ public:
   ~WWorkHours();
 
   void clear();
-  void initializeUi(MonthDB months);
+  void initializeUi();
 
   MonthModel *model() const;
 
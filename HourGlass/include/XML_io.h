@@ -31,11 +31,20 @@
 
 #pragma once
 
-#include <QtCore/QString>
-
 struct Context;
+struct IoError;
+struct Month;
+struct XmlFragments;
 
-class QWidget;
+class QByteArray;
+class QIODevice;
 
-bool xmlRead(Context& context, const QString& xmlContent, QWidget *parent);
-QString xmlWrite(const Context& context, QWidget *parent);
+// NOTE: A lazy read only indexes the months; cf. Context::findMonth().
+// NOTE: A parallel read parses large documents on its own thread pool.
+bool xmlRead(Context& context, const QByteArray& xmlContent, IoError *error = nullptr,
+             const bool lazy = false, const bool parallel = true);
+bool xmlRead(Context& context, QIODevice *device, IoError *error = nullptr);
+bool xmlReadMonth(Month& month, const QByteArray& xmlFragment, IoError *error = nullptr);
+// NOTE: "fragments" is optional and receives the newly serialized elements.
+bool xmlWrite(QIODevice *device, const Context& context, IoError *error = nullptr,
+              XmlFragments *fragments = nullptr);
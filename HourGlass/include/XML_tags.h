@@ -46,5 +46,3 @@
 #define XML_pid          QStringLiteral("pid")
 #define XML_projects     QStringLiteral("projects")
 #define XML_project      QStringLiteral("project")
-#define XML_pidata       QStringLiteral("version=\"1.0\" encoding=\"UTF-8\"")
-#define XML_pitarget     QStringLiteral("xml")
@@ -0,0 +1,246 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QLockFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTimer>
+
+#include "AutoSave.h"
+
+#include "Global.h"
+#include "HoursWriter.h"
+
+////// Macros ////////////////////////////////////////////////////////////////
+
+#define RECOVERY_NAME    QStringLiteral("recovery-%1.%2")
+
+#define RECOVERY_FILE    QStringLiteral("xhours")
+#define RECOVERY_LOCK    QStringLiteral("lock")
+#define RECOVERY_SOURCE  QStringLiteral("source")
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  constexpr int AUTOSAVE_DELAY   = 2000; // [ms]
+  // NOTE: Continuous typing postpones a write by at most this many delays.
+  constexpr int AUTOSAVE_LATENCY = 5;
+
+  // NOTE: Maximum number of concurrent instances with recovery files.
+  constexpr int NUM_SLOTS = 32;
+
+  QString recoveryPath(const int slot, const QString& suffix)
+  {
+    const QDir dir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation));
+    dir.mkpath(QStringLiteral("."));
+
+    return dir.absoluteFilePath(RECOVERY_NAME.arg(slot).arg(suffix));
+  }
+
+} // namespace priv
+
+////// public ////////////////////////////////////////////////////////////////
+
+AutoSave::AutoSave(QObject *parent)
+  : QObject(parent)
+  , _delay{priv::AUTOSAVE_DELAY}
+{
+  _timer = new QTimer(this);
+  _timer->setSingleShot(true);
+
+  _writer = new HoursWriter(this);
+
+  connect(_timer, &QTimer::timeout,
+          this, &AutoSave::write);
+  connect(_writer, &HoursWriter::finished,
+          this, &AutoSave::writeFinished);
+
+  acquireSlot();
+}
+
+AutoSave::~AutoSave()
+{
+  // NOTE: Finishing the write emits finished(), which performs the removal.
+  if( _is_remove_pending ) {
+    _writer->wait();
+  }
+}
+
+int AutoSave::delay() const
+{
+  return _delay;
+}
+
+void AutoSave::setDelay(const int ms)
+{
+  _delay = std::max(ms, 0);
+}
+
+bool AutoSave::isEnabled() const
+{
+  return _is_enabled;
+}
+
+bool AutoSave::hasRecovery() const
+{
+  return _lock  &&  QFile::exists(recoveryFilename());
+}
+
+QString AutoSave::recoveryFilename() const
+{
+  return slotFilename(RECOVERY_FILE);
+}
+
+QString AutoSave::recoverySource() const
+{
+  QFile file(slotFilename(RECOVERY_SOURCE));
+  if( !file.open(QIODevice::ReadOnly) ) {
+    return QString();
+  }
+
+  return QString::fromUtf8(file.readAll());
+}
+
+void AutoSave::removeRecovery()
+{
+  _timer->stop();
+  _is_pending = false;
+
+  // NOTE: A running write would re-create the recovery file.
+  if( _writer->isRunning() ) {
+    _is_remove_pending = true;
+    return;
+  }
+
+  if( _lock ) {
+    QFile::remove(slotFilename(RECOVERY_FILE));
+    QFile::remove(slotFilename(RECOVERY_SOURCE));
+  }
+}
+
+////// public slots //////////////////////////////////////////////////////////
+
+void AutoSave::notify()
+{
+  if( !_is_enabled ) {
+    return;
+  }
+
+  if( !_timer->isActive() ) {
+    _elapsed.start();
+  }
+
+  const qint64 left = qint64(_delay)*priv::AUTOSAVE_LATENCY - _elapsed.elapsed();
+  _timer->start(int(std::clamp<qint64>(left, 0, _delay)));
+}
+
+void AutoSave::setEnabled(const bool on)
+{
+  _is_enabled = on;
+
+  if( !_is_enabled ) {
+    _timer->stop();
+    _is_pending = false;
+  }
+}
+
+void AutoSave::setSource(const QString& filename)
+{
+  _source = filename;
+}
+
+////// private slots /////////////////////////////////////////////////////////
+
+void AutoSave::write()
+{
+  if( !_is_enabled  ||  !_lock  ||  !global.isModified() ) {
+    return;
+  }
+
+  // NOTE: At most one write is in flight; further edits are picked up later.
+  if( _writer->isRunning() ) {
+    _is_pending = true;
+    return;
+  }
+
+  QFile file(slotFilename(RECOVERY_SOURCE));
+  if( file.open(QIODevice::WriteOnly | QIODevice::Truncate) ) {
+    file.write(_source.toUtf8());
+    file.close();
+  }
+
+  _writer->start(recoveryFilename(), global);
+}
+
+void AutoSave::writeFinished(const QString& /*filename*/, const bool /*ok*/)
+{
+  if( _is_remove_pending ) {
+    _is_remove_pending = false;
+    removeRecovery();
+  }
+
+  if( _is_pending ) {
+    _is_pending = false;
+    notify();
+  }
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+void AutoSave::acquireSlot()
+{
+  // NOTE: A slot with recovery files & a stale lock was left by a crash.
+  for(const bool need_recovery : {true, false}) {
+    for(int slot = 0; slot < priv::NUM_SLOTS; slot++) {
+      if( need_recovery  &&  !QFile::exists(priv::recoveryPath(slot, RECOVERY_FILE)) ) {
+        continue;
+      }
+
+      auto lock = std::make_unique<QLockFile>(priv::recoveryPath(slot, RECOVERY_LOCK));
+      if( lock->tryLock(0) ) {
+        _lock = std::move(lock);
+        _slot = slot;
+        return;
+      }
+    }
+  }
+}
+
+QString AutoSave::slotFilename(const QString& suffix) const
+{
+  return _lock
+      ? priv::recoveryPath(_slot, suffix)
+      : QString();
+}
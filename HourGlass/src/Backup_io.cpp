@@ -0,0 +1,436 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <set>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFileInfo>
+#include <QtCore/QLockFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTextStream>
+
+#include "Backup_io.h"
+
+////// Macros ////////////////////////////////////////////////////////////////
+
+#define BACKUP_DIR     QStringLiteral("bakhours")
+#define CHUNKS_DIR     QStringLiteral("chunks")
+#define LOCK_FILE      QStringLiteral("lock")
+#define MANIFESTS_DIR  QStringLiteral("manifests")
+
+#define MANIFEST_MAGIC   QStringLiteral("HGBK")
+#define MANIFEST_SUFFIX  QStringLiteral(".manifest")
+#define MANIFEST_TIME    QStringLiteral("yyyyMMdd-HHmmss")
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  using Chunks = std::vector<QByteArray>; // SHA-256 as hex
+
+  // Content-Defined Chunking ////////////////////////////////////////////////
+
+  constexpr int CHUNK_MIN  =  2*1024;
+  constexpr int CHUNK_MAX  = 64*1024;
+  constexpr int CHUNK_BITS = 13; // 8 KiB on average
+
+  constexpr uint64_t splitmix64(uint64_t x)
+  {
+    x += 0x9E3779B97F4A7C15;
+    x  = (x ^ (x >> 30))*0xBF58476D1CE4E5B9;
+    x  = (x ^ (x >> 27))*0x94D049BB133111EB;
+    return x ^ (x >> 31);
+  }
+
+  constexpr std::array<uint64_t,256> makeGear()
+  {
+    std::array<uint64_t,256> gear{};
+    for(std::size_t i = 0; i < gear.size(); i++) {
+      gear[i] = splitmix64(i);
+    }
+    return gear;
+  }
+
+  constexpr std::array<uint64_t,256> GEAR = makeGear();
+
+  // NOTE: A cut only depends on the preceding 64 bytes; an edit therefore
+  //       only alters the chunks in its vicinity.
+  int nextCut(const char *data, const int size)
+  {
+    if( size <= CHUNK_MIN ) {
+      return size;
+    }
+
+    const int max = std::min(size, CHUNK_MAX);
+
+    uint64_t h = 0;
+    for(int i = 0; i < max; i++) {
+      h = (h << 1) + GEAR[uint8_t(data[i])];
+      if( i >= CHUNK_MIN  &&  (h >> (64 - CHUNK_BITS)) == 0 ) {
+        return i + 1;
+      }
+    }
+
+    return max;
+  }
+
+  // Store ///////////////////////////////////////////////////////////////////
+
+  constexpr int LOCK_TIMEOUT = 10000; // [ms]
+
+  inline QDir backupDir(const QString& filename)
+  {
+    return QDir(QFileInfo(filename).absolutePath()).absoluteFilePath(BACKUP_DIR);
+  }
+
+  inline QString chunkPath(const QDir& bakdir, const QByteArray& hash)
+  {
+    const QString name = QString::fromLatin1(hash);
+
+    return bakdir.absoluteFilePath(QStringLiteral("%1/%2/%3")
+                                   .arg(CHUNKS_DIR, name.left(2), name));
+  }
+
+  inline QDir manifestDir(const QDir& bakdir, const QString& filename)
+  {
+    return bakdir.absoluteFilePath(QStringLiteral("%1/%2")
+                                   .arg(MANIFESTS_DIR, QFileInfo(filename).fileName()));
+  }
+
+  bool writeChunk(const QDir& bakdir, const QByteArray& hash, const QByteArray& data)
+  {
+    const QString path = chunkPath(bakdir, hash);
+    if( QFile::exists(path) ) {
+      return true; // deduplicated!
+    }
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QSaveFile file(path);
+    if( !file.open(QIODevice::WriteOnly) ) {
+      return false;
+    }
+
+    const QByteArray compressed = qCompress(data);
+    if( file.write(compressed) != compressed.size() ) {
+      file.cancelWriting();
+      return false;
+    }
+
+    return file.commit();
+  }
+
+  QByteArray readChunk(const QDir& bakdir, const QByteArray& hash)
+  {
+    QFile file(chunkPath(bakdir, hash));
+    if( !file.open(QIODevice::ReadOnly) ) {
+      return QByteArray();
+    }
+
+    const QByteArray data = qUncompress(file.readAll());
+    if( QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex() != hash ) {
+      return QByteArray();
+    }
+
+    return data;
+  }
+
+  // Manifests ///////////////////////////////////////////////////////////////
+
+  bool writeManifest(const QString& path, const qint64 size, const Chunks& chunks)
+  {
+    QSaveFile file(path);
+    if( !file.open(QIODevice::WriteOnly | QIODevice::Text) ) {
+      return false;
+    }
+
+    QTextStream stream(&file);
+    stream << MANIFEST_MAGIC << ' ' << 1 << '\n';
+    stream << size << '\n';
+    for(const QByteArray& hash : chunks) {
+      stream << QString::fromLatin1(hash) << '\n';
+    }
+    stream.flush();
+
+    return stream.status() == QTextStream::Ok  &&  file.commit();
+  }
+
+  bool readManifest(const QString& path, qint64& size, Chunks& chunks)
+  {
+    QFile file(path);
+    if( !file.open(QIODevice::ReadOnly | QIODevice::Text) ) {
+      return false;
+    }
+
+    if( file.readLine().trimmed() != MANIFEST_MAGIC.toLatin1() + " 1" ) {
+      return false;
+    }
+
+    bool ok{false};
+    size = file.readLine().trimmed().toLongLong(&ok);
+    if( !ok ) {
+      return false;
+    }
+
+    chunks.clear();
+    while( !file.atEnd() ) {
+      const QByteArray hash = file.readLine().trimmed();
+      if( !hash.isEmpty() ) {
+        chunks.push_back(hash);
+      }
+    }
+
+    return true;
+  }
+
+  QDateTime manifestTime(const QString& path)
+  {
+    return QDateTime::fromString(QFileInfo(path).completeBaseName(), MANIFEST_TIME);
+  }
+
+  // Retention ///////////////////////////////////////////////////////////////
+
+  // Keep every backup of the last hour, the newest of each hour of the
+  // last day, of each day of the last month and of each month before.
+  QString retentionBucket(const QDateTime& time, const QDateTime& now)
+  {
+    const qint64 age = time.secsTo(now);
+    if(        age < 3600 ) {
+      return time.toString(QStringLiteral("'s'yyyyMMddHHmmss"));
+    } else if( age < 24*3600 ) {
+      return time.toString(QStringLiteral("'h'yyyyMMddHH"));
+    } else if( age < 31*24*3600 ) {
+      return time.toString(QStringLiteral("'d'yyyyMMdd"));
+    }
+    return time.toString(QStringLiteral("'m'yyyyMM"));
+  }
+
+  void applyRetention(const QDir& mdir)
+  {
+    const QDateTime now = QDateTime::currentDateTime();
+
+    // NOTE: Names sort chronologically; newest first.
+    const QStringList names = mdir.entryList({QStringLiteral("*") + MANIFEST_SUFFIX},
+                                             QDir::Files, QDir::Name | QDir::Reversed);
+
+    std::set<QString> buckets;
+    for(const QString& name : names) {
+      const QDateTime time = manifestTime(name);
+      if( !time.isValid() ) {
+        continue;
+      }
+
+      if( !buckets.insert(retentionBucket(time, now)).second ) {
+        QFile::remove(mdir.absoluteFilePath(name));
+      }
+    }
+  }
+
+  // NOTE: Requires the lock of the store; cf. backupHoursFile().
+  void collectGarbage(const QDir& bakdir)
+  {
+    // (1) Mark referenced chunks of all manifests ///////////////////////////
+
+    std::set<QByteArray> referenced;
+
+    QDirIterator manifests(bakdir.absoluteFilePath(MANIFESTS_DIR),
+                           {QStringLiteral("*") + MANIFEST_SUFFIX},
+                           QDir::Files, QDirIterator::Subdirectories);
+    while( manifests.hasNext() ) {
+      qint64 size;
+      Chunks chunks;
+      if( !readManifest(manifests.next(), size, chunks) ) {
+        return; // do not risk losing data!
+      }
+      referenced.insert(chunks.begin(), chunks.end());
+    }
+
+    // (2) Sweep unreferenced chunks /////////////////////////////////////////
+
+    QDirIterator files(bakdir.absoluteFilePath(CHUNKS_DIR),
+                       QDir::Files, QDirIterator::Subdirectories);
+    while( files.hasNext() ) {
+      const QString path = files.next();
+      if( !referenced.contains(QFileInfo(path).fileName().toLatin1()) ) {
+        QFile::remove(path);
+      }
+    }
+  }
+
+  QString findManifest(const QString& filename, const QDateTime& time)
+  {
+    const QDir mdir = manifestDir(backupDir(filename), filename);
+
+    const QStringList names = mdir.entryList({QStringLiteral("*") + MANIFEST_SUFFIX},
+                                             QDir::Files, QDir::Name | QDir::Reversed);
+    for(const QString& name : names) {
+      const QDateTime t = manifestTime(name);
+      if( t.isValid()  &&  t <= time ) {
+        return mdir.absoluteFilePath(name);
+      }
+    }
+
+    return QString();
+  }
+
+} // namespace priv
+
+////// Public ////////////////////////////////////////////////////////////////
+
+bool backupHoursFile(const QString& filename)
+{
+  // (1) Read file ///////////////////////////////////////////////////////////
+
+  QFile file(filename);
+  if( !file.exists() ) {
+    return true; // nothing to backup!
+  }
+  if( !file.open(QIODevice::ReadOnly) ) {
+    return false;
+  }
+  const QByteArray content = file.readAll();
+  file.close();
+
+  // (2) Lock store //////////////////////////////////////////////////////////
+
+  const QDir bakdir = priv::backupDir(filename);
+  if( !bakdir.mkpath(QStringLiteral(".")) ) {
+    return false;
+  }
+
+  // NOTE: The store may be shared by several instances; without the lock,
+  //       collectGarbage() might remove a chunk, which was deduplicated by
+  //       another instance, before that instance has written its manifest.
+  QLockFile lock(bakdir.absoluteFilePath(LOCK_FILE));
+  if( !lock.tryLock(priv::LOCK_TIMEOUT) ) {
+    return false;
+  }
+
+  // (3) Store chunks ////////////////////////////////////////////////////////
+
+  priv::Chunks chunks;
+  for(int pos = 0; pos < content.size(); ) {
+    const int len = priv::nextCut(content.constData() + pos, content.size() - pos);
+    const QByteArray data = QByteArray::fromRawData(content.constData() + pos, len);
+    const QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex();
+
+    if( !priv::writeChunk(bakdir, hash, data) ) {
+      return false;
+    }
+    chunks.push_back(hash);
+
+    pos += len;
+  }
+
+  // (4) Store manifest //////////////////////////////////////////////////////
+
+  const QDir mdir = priv::manifestDir(bakdir, filename);
+  if( !mdir.mkpath(QStringLiteral(".")) ) {
+    return false;
+  }
+
+  const QString name = QDateTime::currentDateTime().toString(MANIFEST_TIME) + MANIFEST_SUFFIX;
+  if( !priv::writeManifest(mdir.absoluteFilePath(name), content.size(), chunks) ) {
+    return false;
+  }
+
+  // (5) Thin out backups ////////////////////////////////////////////////////
+
+  priv::applyRetention(mdir);
+  priv::collectGarbage(bakdir);
+
+  return true;
+}
+
+BackupTimes listBackups(const QString& filename)
+{
+  const QDir mdir = priv::manifestDir(priv::backupDir(filename), filename);
+
+  const QStringList names = mdir.entryList({QStringLiteral("*") + MANIFEST_SUFFIX},
+                                           QDir::Files, QDir::Name | QDir::Reversed);
+
+  BackupTimes result;
+  for(const QString& name : names) {
+    const QDateTime time = priv::manifestTime(name);
+    if( time.isValid() ) {
+      result.push_back(time);
+    }
+  }
+
+  return result;
+}
+
+bool restoreBackup(const QString& filename, const QDateTime& time, const QString& target)
+{
+  // (1) Read manifest ///////////////////////////////////////////////////////
+
+  const QString path = priv::findManifest(filename, time);
+  if( path.isEmpty() ) {
+    return false;
+  }
+
+  qint64 size;
+  priv::Chunks chunks;
+  if( !priv::readManifest(path, size, chunks) ) {
+    return false;
+  }
+
+  // (2) Reassemble file /////////////////////////////////////////////////////
+
+  const QDir bakdir = priv::backupDir(filename);
+
+  QSaveFile file(target);
+  if( !file.open(QIODevice::WriteOnly) ) {
+    return false;
+  }
+
+  qint64 numWritten = 0;
+  for(const QByteArray& hash : chunks) {
+    const QByteArray data = priv::readChunk(bakdir, hash);
+    if( data.isEmpty()  ||  file.write(data) != data.size() ) {
+      file.cancelWriting();
+      return false;
+    }
+    numWritten += data.size();
+  }
+
+  if( numWritten != size ) {
+    file.cancelWriting();
+    return false;
+  }
+
+  return file.commit();
+}
@@ -0,0 +1,353 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+
+#include "Binary_io.h"
+
+#include "Context.h"
+#include "IoError.h"
+
+////// Macros ////////////////////////////////////////////////////////////////
+
+#define TR_CTX  "Binary_io"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+/*
+ * Layout (little endian):
+ *
+ * Header  : magic "HGBN", quint16 version, quint16 flags,
+ *           quint32 #projects, quint32 #strings, quint32 #months
+ * Projects: #projects x { quint32 pid, QString name, QString annotation }
+ * Strings : #strings  x { QString activity }
+ * Months  : #months   x { qint32 mid, quint32 #items,
+ *                         #items x { quint32 pid, quint32 activity },
+ *                         #items x Hours }
+ */
+
+constexpr char    BIN_MAGIC[]    = {'H', 'G', 'B', 'N'};
+constexpr int     BIN_MAGIC_SIZE = int(sizeof(BIN_MAGIC));
+constexpr quint16 BIN_VERSION    = 1;
+
+// NOTE: Hours are stored as doubles; cf. numhour_t::fromDouble().
+using BinHours = std::array<double,NUM_DAYS>;
+
+static_assert( sizeof(BinHours) == BinHours().size()*sizeof(double) );
+
+using StringTable = QHash<QString,quint32>;
+
+inline void binSetup(QDataStream& stream)
+{
+  stream.setVersion(QDataStream::Qt_5_12);
+  stream.setByteOrder(QDataStream::LittleEndian);
+  stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+}
+
+inline bool binIsOk(const QDataStream& stream)
+{
+  return stream.status() == QDataStream::Ok;
+}
+
+////// Private - Read ////////////////////////////////////////////////////////
+
+bool binReadHours(QDataStream& stream, Hours& hours)
+{
+  BinHours values;
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+  constexpr int SIZE = int(sizeof(BinHours));
+  if( stream.readRawData(reinterpret_cast<char*>(values.data()), SIZE) != SIZE ) {
+    return false;
+  }
+#else
+  for(double& value : values) {
+    stream >> value;
+  }
+  if( !binIsOk(stream) ) {
+    return false;
+  }
+#endif
+
+  HoursArray result;
+  for(std::size_t i = 0; i < values.size(); i++) {
+    if( !numhour_t::fromDouble(result[i], values[i]) ) {
+      return false;
+    }
+  }
+
+  hours = Hours(result);
+
+  return true;
+}
+
+bool binReadMonth(Context& context, QDataStream& stream, const QStringList& strings)
+{
+  qint32 mid{INVALID_MONTHID};
+  quint32 numItems{0};
+  stream >> mid >> numItems;
+  if( !binIsOk(stream) ) {
+    return false;
+  }
+
+  const SplitId sid = split_monthid(mid);
+
+  if( !context.add(Month(sid.first, sid.second)) ) {
+    return false;
+  }
+
+  Month *month = context.findMonth(mid);
+  if( month == nullptr ) {
+    return false;
+  }
+
+  for(quint32 i = 0; i < numItems; i++) {
+    quint32 pid{INVALID_PROJECTID};
+    quint32 sidx{0};
+    stream >> pid >> sidx;
+    if( !binIsOk(stream)  ||  sidx >= quint32(strings.size()) ) {
+      return false;
+    }
+
+    if( !month->add(Item(pid, strings[int(sidx)])) ) {
+      return false;
+    }
+  }
+
+  for(Item& item : month->items) {
+    if( !binReadHours(stream, item.hours) ) {
+      return false;
+    }
+  }
+  month->invalidateTotals();
+
+  return true;
+}
+
+bool binReadContext(Context& context, QDataStream& stream)
+{
+  // (1) Header //////////////////////////////////////////////////////////////
+
+  char magic[BIN_MAGIC_SIZE];
+  if( stream.readRawData(magic, BIN_MAGIC_SIZE) != BIN_MAGIC_SIZE  ||
+      std::memcmp(magic, BIN_MAGIC, BIN_MAGIC_SIZE) != 0 ) {
+    return false;
+  }
+
+  quint16 version{0};
+  quint16 flags{0};
+  quint32 numProjects{0};
+  quint32 numStrings{0};
+  quint32 numMonths{0};
+  stream >> version >> flags >> numProjects >> numStrings >> numMonths;
+  if( !binIsOk(stream)  ||  version < 1  ||  version > BIN_VERSION ) {
+    return false;
+  }
+
+  // (2) Projects ////////////////////////////////////////////////////////////
+
+  for(quint32 i = 0; i < numProjects; i++) {
+    quint32 pid{INVALID_PROJECTID};
+    QString name;
+    QString annotation;
+    stream >> pid >> name >> annotation;
+    if( !binIsOk(stream) ) {
+      return false;
+    }
+
+    if( !context.add({pid, name, annotation}) ) {
+      return false;
+    }
+  }
+
+  // (3) Strings /////////////////////////////////////////////////////////////
+
+  QStringList strings;
+  for(quint32 i = 0; i < numStrings; i++) {
+    QString s;
+    stream >> s;
+    if( !binIsOk(stream) ) {
+      return false;
+    }
+
+    strings.push_back(std::move(s));
+  }
+
+  // (4) Months //////////////////////////////////////////////////////////////
+
+  for(quint32 i = 0; i < numMonths; i++) {
+    if( !binReadMonth(context, stream, strings) ) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+////// Private - Write ///////////////////////////////////////////////////////
+
+void binWriteHours(QDataStream& stream, const Hours& hours)
+{
+  const HoursArray array = hours.toArray();
+
+  BinHours values;
+  for(std::size_t i = 0; i < values.size(); i++) {
+    values[i] = array[i].toDouble();
+  }
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+  stream.writeRawData(reinterpret_cast<const char*>(values.data()), int(sizeof(BinHours)));
+#else
+  for(const double value : values) {
+    stream << value;
+  }
+#endif
+}
+
+void binWriteMonth(QDataStream& stream, const Month& month, const StringTable& index)
+{
+  stream << qint32(month.id()) << quint32(month.items.size());
+
+  for(const Item& item : month.items) {
+    stream << quint32(item.projectId) << index.value(item.activity);
+  }
+
+  for(const Item& item : month.items) {
+    binWriteHours(stream, item.hours);
+  }
+}
+
+////// Public ////////////////////////////////////////////////////////////////
+
+bool binRead(Context& context, QIODevice *device, IoError *error)
+{
+  context.clear();
+
+  QDataStream stream(device);
+  binSetup(stream);
+
+  if( !binReadContext(context, stream) ) {
+    return setIoError(error, IoError::ReadError,
+                      QCoreApplication::translate(TR_CTX, "Invalid binary data at offset %1!")
+                      .arg(device->pos()));
+  }
+
+  return true;
+}
+
+bool binWrite(QIODevice *device, const Context& context, IoError *error)
+{
+  QDataStream stream(device);
+  binSetup(stream);
+
+  const ProjectIDs projects = context.listProjects();
+  const MonthIDs     months = context.listMonths();
+
+  // (1) Load months /////////////////////////////////////////////////////////
+
+  // NOTE: Lazily loaded months are parsed into local copies, i.e. the
+  //       context is left unchanged; a month failing to parse fails the
+  //       write instead of being dropped.
+  std::deque<Month> parsed;
+  std::vector<const Month*> monthPtrs;
+  monthPtrs.reserve(months.size());
+  for(const monthid_t id : months) {
+    IoError loadError;
+    Month buffer;
+    const Month *m = context.viewMonth(id, buffer, &loadError);
+    if( m == nullptr ) {
+      return setIoError(error, IoError::WriteError, loadError.message);
+    }
+
+    if( m == &buffer ) {
+      parsed.push_back(std::move(buffer));
+      m = &parsed.back();
+    }
+
+    monthPtrs.push_back(m);
+  }
+
+  // (2) Collect activities //////////////////////////////////////////////////
+
+  QStringList strings;
+  StringTable index;
+  for(const Month *m : monthPtrs) {
+    for(const Item& item : m->items) {
+      if( index.contains(item.activity) ) {
+        continue;
+      }
+
+      index.insert(item.activity, quint32(strings.size()));
+      strings.push_back(item.activity);
+    }
+  }
+
+  // (3) Header //////////////////////////////////////////////////////////////
+
+  stream.writeRawData(BIN_MAGIC, BIN_MAGIC_SIZE);
+  stream << BIN_VERSION << quint16{0}
+         << quint32(projects.size())
+         << quint32(strings.size())
+         << quint32(months.size());
+
+  // (4) Projects ////////////////////////////////////////////////////////////
+
+  for(const projectid_t id : projects) {
+    const Project *p = context.findProject(id);
+    stream << quint32(p->id()) << p->name << p->annotation;
+  }
+
+  // (5) Strings /////////////////////////////////////////////////////////////
+
+  for(const QString& s : qAsConst(strings)) {
+    stream << s;
+  }
+
+  // (6) Months //////////////////////////////////////////////////////////////
+
+  for(const Month *m : monthPtrs) {
+    binWriteMonth(stream, *m, index);
+  }
+
+  if( !binIsOk(stream) ) {
+    return setIoError(error, IoError::WriteError,
+                      QCoreApplication::translate(TR_CTX, "Unable to write binary data! (%1)")
+                      .arg(device->errorString()));
+  }
+
+  return true;
+}
@@ -0,0 +1,294 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <QtCore/QtEndian>
+
+#include "Compress_io.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  constexpr char COMPRESS_MAGIC[4] = {'H', 'G', 'Z', '1'};
+
+  constexpr int COMPRESS_BLOCK = 256*1024;
+
+  // NOTE: qCompress() prepends the uncompressed size as 32bit big endian.
+  constexpr int QCOMPRESS_HEADER = 4;
+
+  constexpr int SIZE_LENGTH = sizeof(quint32);
+
+} // namespace priv
+
+////// Public ////////////////////////////////////////////////////////////////
+
+bool isCompressed(const QByteArray& data)
+{
+  return
+      data.size() >= int(sizeof(priv::COMPRESS_MAGIC))  &&
+      std::memcmp(data.constData(), priv::COMPRESS_MAGIC, sizeof(priv::COMPRESS_MAGIC)) == 0;
+}
+
+bool uncompressAll(QByteArray& result, const QByteArray& data)
+{
+  result.clear();
+
+  if( !isCompressed(data) ) {
+    return false;
+  }
+
+  const char *ptr = data.constData() + sizeof(priv::COMPRESS_MAGIC);
+  const char *end = data.constData() + data.size();
+
+  // (1) Determine uncompressed size /////////////////////////////////////////
+
+  qint64 size = 0;
+  for(const char *blk = ptr; end - blk >= priv::SIZE_LENGTH; ) {
+    const quint32 length = qFromLittleEndian<quint32>(blk);
+    blk += priv::SIZE_LENGTH;
+    if( length == 0 ) {
+      break;
+    }
+    if( length < quint32(priv::QCOMPRESS_HEADER)  ||  quint32(end - blk) < length ) {
+      return false;
+    }
+    size += qFromBigEndian<quint32>(blk);
+    blk += length;
+  }
+  if( size > qint64(std::numeric_limits<int>::max()) ) {
+    return false;
+  }
+  result.reserve(int(size));
+
+  // (2) Uncompress blocks ///////////////////////////////////////////////////
+
+  while( end - ptr >= priv::SIZE_LENGTH ) {
+    const quint32 length = qFromLittleEndian<quint32>(ptr);
+    ptr += priv::SIZE_LENGTH;
+    if( length == 0 ) {
+      return true;
+    }
+
+    const QByteArray block = qUncompress(reinterpret_cast<const uchar*>(ptr), int(length));
+    if( block.isEmpty() ) {
+      result.clear();
+      return false;
+    }
+    result.append(block);
+
+    ptr += length;
+  }
+
+  // NOTE: Missing terminator, i.e. truncated file!
+  result.clear();
+
+  return false;
+}
+
+////// public ////////////////////////////////////////////////////////////////
+
+CompressDevice::CompressDevice(QIODevice *device)
+  : QIODevice()
+  , _device{device}
+{
+}
+
+CompressDevice::~CompressDevice()
+{
+  close();
+}
+
+bool CompressDevice::atEnd() const
+{
+  return _is_finished  &&  _pos >= _block.size();
+}
+
+qint64 CompressDevice::bytesAvailable() const
+{
+  return qint64(_block.size() - _pos) + QIODevice::bytesAvailable();
+}
+
+void CompressDevice::close()
+{
+  if( !isOpen() ) {
+    return;
+  }
+
+  if( isWritable() ) {
+    finish();
+  }
+
+  QIODevice::close();
+  _block.clear();
+  _pos = 0;
+}
+
+bool CompressDevice::finish()
+{
+  if( !isWritable()  ||  _is_finished ) {
+    return _is_finished;
+  }
+
+  const char terminator[priv::SIZE_LENGTH] = {0, 0, 0, 0};
+
+  _is_finished =
+      writeBlock()                                                   &&
+      _device->write(terminator, priv::SIZE_LENGTH) == priv::SIZE_LENGTH;
+
+  return _is_finished;
+}
+
+bool CompressDevice::isSequential() const
+{
+  return true;
+}
+
+bool CompressDevice::open(OpenMode mode)
+{
+  if( _device == nullptr  ||  isOpen() ) {
+    return false;
+  }
+
+  const OpenMode rw = mode & ReadWrite;
+  if( rw != ReadOnly  &&  rw != WriteOnly ) {
+    return false;
+  }
+
+  _block.clear();
+  _is_finished = false;
+  _pos = 0;
+
+  if( rw == ReadOnly ) {
+    if( _device->read(sizeof(priv::COMPRESS_MAGIC)) !=
+        QByteArray::fromRawData(priv::COMPRESS_MAGIC, sizeof(priv::COMPRESS_MAGIC)) ) {
+      return false;
+    }
+  } else {
+    if( _device->write(priv::COMPRESS_MAGIC, sizeof(priv::COMPRESS_MAGIC)) !=
+        qint64(sizeof(priv::COMPRESS_MAGIC)) ) {
+      return false;
+    }
+    _block.reserve(priv::COMPRESS_BLOCK);
+  }
+
+  return QIODevice::open(rw | Unbuffered);
+}
+
+////// protected /////////////////////////////////////////////////////////////
+
+qint64 CompressDevice::readData(char *data, qint64 maxSize)
+{
+  qint64 numRead = 0;
+  while( numRead < maxSize ) {
+    if( _pos >= _block.size() ) {
+      if( _is_finished ) {
+        break;
+      }
+      if( !readBlock() ) {
+        return -1;
+      }
+      continue;
+    }
+
+    const qint64 num = std::min<qint64>(maxSize - numRead, _block.size() - _pos);
+    std::memcpy(data + numRead, _block.constData() + _pos, size_t(num));
+    numRead += num;
+    _pos    += int(num);
+  }
+
+  return numRead;
+}
+
+qint64 CompressDevice::writeData(const char *data, qint64 maxSize)
+{
+  qint64 numWritten = 0;
+  while( numWritten < maxSize ) {
+    const qint64 num = std::min<qint64>(maxSize - numWritten,
+                                        priv::COMPRESS_BLOCK - _block.size());
+    _block.append(data + numWritten, int(num));
+    numWritten += num;
+
+    if( _block.size() >= priv::COMPRESS_BLOCK  &&  !writeBlock() ) {
+      return -1;
+    }
+  }
+
+  return numWritten;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+bool CompressDevice::readBlock()
+{
+  _block.clear();
+  _pos = 0;
+
+  const QByteArray size = _device->read(priv::SIZE_LENGTH);
+  if( size.size() != priv::SIZE_LENGTH ) {
+    return false; // truncated!
+  }
+
+  const quint32 length = qFromLittleEndian<quint32>(size.constData());
+  if( length == 0 ) {
+    _is_finished = true;
+    return true;
+  }
+
+  const QByteArray compressed = _device->read(qint64(length));
+  if( compressed.size() != int(length) ) {
+    return false;
+  }
+
+  _block = qUncompress(compressed);
+
+  return !_block.isEmpty();
+}
+
+bool CompressDevice::writeBlock()
+{
+  if( _block.isEmpty() ) {
+    return true;
+  }
+
+  const QByteArray compressed = qCompress(_block);
+  _block.resize(0); // keep capacity
+
+  char size[priv::SIZE_LENGTH];
+  qToLittleEndian<quint32>(quint32(compressed.size()), size);
+
+  return
+      _device->write(size, priv::SIZE_LENGTH) == priv::SIZE_LENGTH        &&
+      _device->write(compressed) == compressed.size();
+}
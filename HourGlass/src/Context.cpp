@@ -29,28 +29,38 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <algorithm>
+#include <limits>
+
+#include <QtCore/QCoreApplication>
+
 #include "Context.h"
 
+#include "IoError.h"
+#include "XML_io.h"
+
+////// Macros ////////////////////////////////////////////////////////////////
+
+#define TR_CTX  "Context"
+
 ////// Private ///////////////////////////////////////////////////////////////
 
 static_assert( std::is_unsigned_v<std::size_t> );
 
-inline bool operator<(const ProjectDB::value_type& a, const ProjectDB::value_type& b)
-{
-  return a.second.id() < b.second.id();
-}
-
 ////// public ////////////////////////////////////////////////////////////////
 
 Context::Context() noexcept
   : _months()
+  , _monthFragments()
   , _projects()
+  , _projectFragments()
 {
   clear();
 }
 
 bool Context::isValid() const
 {
+  // NOTE: Months not yet loaded are validated by loadMonth().
   for(const auto& v : _months) {
     for(const Item& item : v.second.items) {
       if( !isProject(item.projectId) ) {
@@ -65,10 +75,31 @@ bool Context::isValid() const
 void Context::clear()
 {
   _months.clear();
+  _monthFragments.clear();
   _projects.clear();
+  _projectFragments.clear();
   clearModified();
 }
 
+Context Context::snapshot() const
+{
+  Context result;
+
+  result._is_modified      = _is_modified;
+  result._revision         = _revision;
+  result._monthFragments   = _monthFragments;
+  result._projects         = _projects;
+  result._projectFragments = _projectFragments;
+
+  for(const auto& v : _months) {
+    if( !_monthFragments.contains(v.first) ) {
+      result._months.emplace(v.first, v.second);
+    }
+  }
+
+  return result;
+}
+
 ////// public - Modification State ///////////////////////////////////////////
 
 void Context::clearModified()
@@ -81,9 +112,24 @@ bool Context::isModified() const
   return _is_modified;
 }
 
+std::size_t Context::revision() const
+{
+  return _revision;
+}
+
 void Context::setModified()
 {
   _is_modified = true;
+  _revision++;
+
+  if( _modifiedHandler.func ) {
+    _modifiedHandler.func();
+  }
+}
+
+void Context::setModifiedHandler(ModifiedHandler handler)
+{
+  _modifiedHandler.func = std::move(handler);
 }
 
 ////// public - Month ////////////////////////////////////////////////////////
@@ -94,72 +140,122 @@ bool Context::add(Month m)
     return false;
   }
 
-  const auto result = _months.emplace(m.id(), std::move(m));
+  const auto result = _months.emplace(to_monthord(m.id()), std::move(m));
 
   setModified();
 
   return isMonth(result.first->second.id());
 }
 
-Month *Context::findMonth(const monthid_t id) const
+bool Context::add(const monthid_t id, QByteArray fragment)
 {
-  const auto hit = _months.find(id);
+  const SplitId sid = split_monthid(id);
+
+  if( !Month(sid.first, sid.second)  ||  isMonth(id)  ||  fragment.isEmpty() ) {
+    return false;
+  }
+
+  _monthFragments.emplace(to_monthord(id), std::move(fragment));
+
+  return true;
+}
+
+Month *Context::findMonth(const monthid_t id, IoError *error) const
+{
+  const auto hit = _months.find(to_monthord(id));
 
   return hit != _months.cend()
       ? &const_cast<Month&>(hit->second)
+      : loadMonth(id, error);
+}
+
+const Month *Context::viewMonth(const monthid_t id, Month& buffer, IoError *error) const
+{
+  const auto hit = _months.find(to_monthord(id));
+  if( hit != _months.cend() ) {
+    return &hit->second;
+  }
+
+  return parseMonth(buffer, id, error)
+      ? &buffer
       : nullptr;
 }
 
 bool Context::isMonth(const monthid_t id) const
 {
-  return _months.contains(id);
+  const monthord_t ord = to_monthord(id);
+
+  return _months.contains(ord)  ||  _monthFragments.contains(ord);
+}
+
+bool Context::isMonthModified(const monthid_t id) const
+{
+  return isMonth(id)  &&  !_monthFragments.contains(to_monthord(id));
 }
 
 MonthIDs Context::listMonths() const
 {
-  if( _months.empty() ) {
+  if( _months.empty()  &&  _monthFragments.empty() ) {
     return MonthIDs();
   }
 
-  MonthIDs result;
+  return listRange(std::numeric_limits<monthord_t>::lowest(),
+                   std::numeric_limits<monthord_t>::max());
+}
 
-  result.reserve(_months.size());
-  for(const auto& v : _months) {
-    result.push_back(v.second.id());
+MonthIDs Context::listMonths(const monthid_t first, const monthid_t last) const
+{
+  return listRange(to_monthord(first), to_monthord(last));
+}
+
+MonthIDs Context::listQuarter(const int year, const int quarter) const
+{
+  if( quarter < 1  ||  quarter > 4 ) {
+    return MonthIDs();
   }
 
-  std::sort(result.begin(), result.end(), std::greater<monthid_t>());
+  const int firstMonth = (quarter - 1)*3 + 1;
 
-  return result;
+  return listMonths(make_monthid(year, firstMonth), make_monthid(year, firstMonth + 2));
+}
+
+MonthIDs Context::listYear(const int year) const
+{
+  return listMonths(make_monthid(year, 1), make_monthid(year, 12));
 }
 
 void Context::set(MonthDB months)
 {
   _months = std::move(months);
+  _monthFragments.clear();
+}
+
+void Context::setMonthModified(const monthid_t id)
+{
+  // NOTE: The fragment of a month not yet loaded is its only data!
+  if( findMonth(id) != nullptr ) {
+    _monthFragments.erase(to_monthord(id));
+  }
+
+  setModified();
 }
 
 ////// public - Project //////////////////////////////////////////////////////
 
 bool Context::add(Project p)
 {
-  if( !p  ||  isProject(p.id()) ) {
+  if( !_projects.add(std::move(p)) ) {
     return false;
   }
 
-  const auto result = _projects.emplace(p.id(), std::move(p));
-
   setModified();
 
-  return isProject(result.first->second.id());
+  return true;
 }
 
 Project *Context::findProject(const projectid_t id) const
 {
-  const auto hit = _projects.find(id);
-
-  return hit != _projects.cend()
-      ? &const_cast<Project&>(hit->second)
-      : nullptr;
+  return const_cast<Project*>(_projects.find(id));
 }
 
 bool Context::isProject(const projectid_t id) const
@@ -167,32 +263,29 @@ bool Context::isProject(const projectid_t id) const
   return _projects.contains(id);
 }
 
-ProjectIDs Context::listProjects() const
+bool Context::isProjectModified(const projectid_t id) const
 {
-  if( _projects.empty() ) {
-    return ProjectIDs();
-  }
-
-  ProjectIDs result;
-
-  result.reserve(_projects.size());
-  for(const auto& v : _projects) {
-    result.push_back(v.second.id());
-  }
+  return isProject(id)  &&  !_projectFragments.contains(id);
+}
 
-  std::sort(result.begin(), result.end());
+ProjectIDs Context::listProjects() const
+{
+  return _projects.ids();
+}
 
-  return result;
+const ProjectIDs& Context::listProjectsByName() const
+{
+  return _projects.nameIndex();
 }
 
 Project Context::makeProject(const QString& name) const
 {
   constexpr projectid_t ONE = 1;
 
-  const auto hit = std::max_element(_projects.cbegin(), _projects.cend());
+  const projectid_t maxId = _projects.maxId();
 
-  const projectid_t newId = hit != _projects.cend()
-      ? hit->second.id() + ONE
+  const projectid_t newId = maxId != INVALID_PROJECTID
+      ? maxId + ONE
       : ONE;
 
   return Project(newId, name);
@@ -201,4 +294,144 @@ Project Context::makeProject(const QString& name) const
 void Context::set(ProjectDB projects)
 {
   _projects = std::move(projects);
+  _projectFragments.clear();
+}
+
+void Context::setProjectModified(const projectid_t id)
+{
+  _projectFragments.erase(id);
+  _projects.invalidateNameIndex();
+
+  setModified();
+}
+
+////// public - XML Fragments ////////////////////////////////////////////////
+
+void Context::cacheFragments(XmlFragments fragments)
+{
+  for(auto& v : fragments.months) {
+    cacheMonthFragment(from_monthord(v.first), std::move(v.second));
+  }
+  for(auto& v : fragments.projects) {
+    cacheProjectFragment(v.first, std::move(v.second));
+  }
+}
+
+void Context::cacheMonthFragment(const monthid_t id, QByteArray fragment)
+{
+  if( !isMonth(id)  ||  fragment.isEmpty() ) {
+    return;
+  }
+
+  _monthFragments.insert_or_assign(to_monthord(id), std::move(fragment));
+}
+
+void Context::cacheProjectFragment(const projectid_t id, QByteArray fragment)
+{
+  if( !isProject(id)  ||  fragment.isEmpty() ) {
+    return;
+  }
+
+  _projectFragments.insert_or_assign(id, std::move(fragment));
+}
+
+QByteArray Context::monthFragment(const monthid_t id) const
+{
+  const auto hit = _monthFragments.find(to_monthord(id));
+
+  return hit != _monthFragments.cend()
+      ? hit->second
+      : QByteArray();
+}
+
+QByteArray Context::projectFragment(const projectid_t id) const
+{
+  const auto hit = _projectFragments.find(id);
+
+  return hit != _projectFragments.cend()
+      ? hit->second
+      : QByteArray();
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+MonthIDs Context::listRange(const monthord_t first, const monthord_t last) const
+{
+  if( first > last ) {
+    return MonthIDs();
+  }
+
+  auto m    = _months.lower_bound(first);
+  auto mEnd = _months.upper_bound(last);
+  auto f    = _monthFragments.lower_bound(first);
+  auto fEnd = _monthFragments.upper_bound(last);
+
+  // (1) Union of loaded months & fragments; both are ordered ////////////////
+
+  MonthIDs result;
+  while( m != mEnd  ||  f != fEnd ) {
+    if(        f == fEnd  ||  (m != mEnd  &&  m->first < f->first) ) {
+      result.push_back(from_monthord(m->first));
+      ++m;
+    } else if( m == mEnd  ||  f->first < m->first ) { // not yet loaded
+      result.push_back(from_monthord(f->first));
+      ++f;
+    } else { // loaded & cached
+      result.push_back(from_monthord(m->first));
+      ++m;
+      ++f;
+    }
+  }
+
+  // (2) Newest first ////////////////////////////////////////////////////////
+
+  std::reverse(result.begin(), result.end());
+
+  return result;
+}
+
+Month *Context::loadMonth(const monthid_t id, IoError *error) const
+{
+  // NOTE: On failure the fragment is kept, i.e. an XML save writes it back as read.
+
+  Month month;
+  if( !parseMonth(month, id, error) ) {
+    return nullptr;
+  }
+
+  // NOTE: The fragment is retained as long as the month is not modified.
+  const auto result = _months.emplace(to_monthord(id), std::move(month));
+
+  return &result.first->second;
+}
+
+bool Context::parseMonth(Month& month, const monthid_t id, IoError *error) const
+{
+  const auto hit = _monthFragments.find(to_monthord(id));
+  if( hit == _monthFragments.cend() ) {
+    return false;
+  }
+
+  IoError readError;
+  if( !xmlReadMonth(month, hit->second, &readError) ) {
+    return setIoError(error, IoError::ReadError,
+                      QCoreApplication::translate(TR_CTX, "Invalid month %1! (%2)")
+                      .arg(id).arg(readError.message));
+  }
+
+  if( month.id() != id ) {
+    return setIoError(error, IoError::ReadError,
+                      QCoreApplication::translate(TR_CTX, "Invalid month %1!")
+                      .arg(id));
+  }
+
+  for(const Item& item : month.items) {
+    if( !isProject(item.projectId) ) {
+      return setIoError(error, IoError::ReadError,
+                        QCoreApplication::translate(TR_CTX, "Invalid project ID %1 in month %2!")
+                        .arg(item.projectId).arg(id));
+    }
+  }
+
+  return true;
 }
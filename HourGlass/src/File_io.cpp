@@ -29,87 +29,113 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <limits>
+
 #include <QtCore/QCoreApplication>
-#include <QtCore/QDateTime>
-#include <QtCore/QDir>
 #include <QtCore/QFileInfo>
-#include <QtCore/QTextStream>
-#include <QtWidgets/QMessageBox>
+#include <QtCore/QSaveFile>
 
 #include "File_io.h"
 
+#include "Binary_io.h"
+#include "Compress_io.h"
 #include "Context.h"
+#include "IoError.h"
 #include "XML_io.h"
 
 ////// Macros ///////////////////////////////////////////////////////////////
 
-#define BACKUP_DIR  QStringLiteral("bakhours")
+#define BINARY_SUFFIX      QStringLiteral("hgbin")
+#define COMPRESSED_SUFFIX  QStringLiteral("z")
 
 #define TR_CTX  "File_io"
 
-////// Public ////////////////////////////////////////////////////////////////
+////// Private ///////////////////////////////////////////////////////////////
 
-bool backupHoursFile(const QString& filename)
+inline bool isBinaryFile(const QString& filename)
 {
-  const QFileInfo info(filename);
-  if( !info.exists() ) {
-    return true; // nothing to backup!
-  }
+  return QFileInfo(filename).suffix().compare(BINARY_SUFFIX, Qt::CaseInsensitive) == 0;
+}
 
-  const QDir dir = info.canonicalPath();
-  dir.mkdir(BACKUP_DIR);
+inline bool isCompressedFile(const QString& filename)
+{
+  return QFileInfo(filename).suffix().compare(COMPRESSED_SUFFIX, Qt::CaseInsensitive) == 0;
+}
 
-  const QDir bakdir = dir.absoluteFilePath(BACKUP_DIR);
-  if( !bakdir.exists() ) {
-    return false;
+inline uchar *mapFile(QFile& file)
+{
+  const qint64 size = file.size();
+  if( size < 1  ||  size > qint64(std::numeric_limits<int>::max()) ) {
+    return nullptr;
   }
 
-  const QString time = QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd-HHmmss"));
-  const QString bakfilename = QStringLiteral("%1-%2.%3")
-      .arg(info.completeBaseName(), time, info.suffix());
-
-  return QFile::copy(filename, bakdir.absoluteFilePath(bakfilename));
+  return file.map(0, size);
 }
 
-bool readHoursFile(Context& context, const QString& filename, QWidget *parent)
+////// Public ////////////////////////////////////////////////////////////////
+
+bool readHoursFile(Context& context, const QString& filename, IoError *error,
+                   const bool lazy, const bool parallel)
 {
   context.clear();
 
-  const QString fileInfo = QFileInfo(filename).fileName();
+  if( error != nullptr ) {
+    *error = IoError();
+    error->filename = filename;
+  }
 
   // (1) Open file for reading ///////////////////////////////////////////////
 
   QFile file(filename);
   if( !file.open(QFile::ReadOnly) ) {
-    QMessageBox::critical(parent, QCoreApplication::translate(TR_CTX, "Error"),
-                          QCoreApplication::translate(TR_CTX, "Unable to open file \"%1\"!")
-                          .arg(fileInfo));
-    return false;
+    return setIoError(error, IoError::OpenError,
+                      QCoreApplication::translate(TR_CTX, "Unable to open file! (%1)")
+                      .arg(file.errorString()));
   }
 
-  // (2) Deserialize XML /////////////////////////////////////////////////////
-
-  QTextStream stream(&file);
-  stream.setCodec("UTF-8");
-  const QString xmlContent = stream.readAll();
+  // (2) Parse file //////////////////////////////////////////////////////////
+
+  const bool is_binary = isBinaryFile(filename);
+
+  bool ok{false};
+  if( is_binary ) {
+    ok = binRead(context, &file, error);
+  } else {
+    uchar *data = mapFile(file);
+    if( data != nullptr ) {
+      // NOTE: Zero-copy view of the mapped UTF-8 bytes.
+      const QByteArray content =
+          QByteArray::fromRawData(reinterpret_cast<const char*>(data), int(file.size()));
+      if( isCompressed(content) ) {
+        QByteArray xmlContent;
+        ok = uncompressAll(xmlContent, content)  &&
+            xmlRead(context, xmlContent, error, lazy, parallel);
+      } else {
+        ok = xmlRead(context, content, error, lazy, parallel);
+      }
+      file.unmap(data);
+    } else if( isCompressed(file.peek(4)) ) {
+      CompressDevice device(&file);
+      ok = device.open(QIODevice::ReadOnly)  &&  xmlRead(context, &device, error);
+    } else {
+      ok = xmlRead(context, &file, error);
+    }
+  }
   file.close();
 
-  // (3) Parse XML ///////////////////////////////////////////////////////////
-
-  if( !xmlRead(context, xmlContent, parent) ) {
-    QMessageBox::critical(parent, QCoreApplication::translate(TR_CTX, "Error"),
-                          QCoreApplication::translate(TR_CTX, "Unable to read XML file \"%1\"!")
-                          .arg(fileInfo));
+  if( !ok ) {
+    if( error != nullptr  &&  !error->isError() ) {
+      setIoError(error, IoError::ReadError,
+                 QCoreApplication::translate(TR_CTX, "Invalid compressed data!"));
+    }
     return false;
   }
 
-  // (4) Validate Context ////////////////////////////////////////////////////
+  // (3) Validate Context ////////////////////////////////////////////////////
 
   if( !context ) {
-    QMessageBox::critical(parent, QCoreApplication::translate(TR_CTX, "Error"),
-                          QCoreApplication::translate(TR_CTX, "Invalid context! (\"%1\")")
-                          .arg(fileInfo));
-    return false;
+    return setIoError(error, IoError::InvalidContext,
+                      QCoreApplication::translate(TR_CTX, "Invalid context!"));
   }
 
   // Done! ///////////////////////////////////////////////////////////////////
@@ -117,32 +143,61 @@ bool readHoursFile(Context& context, const QString& filename, QWidget *parent)
   return true;
 }
 
-bool writeHoursFile(const QString& filename, const Context& context, QWidget *parent)
+bool writeHoursFile(const QString& filename, const Context& context, IoError *error,
+                    XmlFragments *fragments)
 {
+  if( error != nullptr ) {
+    *error = IoError();
+    error->filename = filename;
+  }
+
   // (1) Open file for writing ///////////////////////////////////////////////
 
-  QFile file(filename);
+  // NOTE: The file is replaced atomically upon commit().
+  QSaveFile file(filename);
   if( !file.open(QFile::WriteOnly) ) {
-    QMessageBox::critical(parent, QCoreApplication::translate(TR_CTX, "Error"),
-                          QCoreApplication::translate(TR_CTX, "Unable to save file \"%1\"!")
-                          .arg(QFileInfo(filename).fileName()));
-    return false;
+    return setIoError(error, IoError::OpenError,
+                      QCoreApplication::translate(TR_CTX, "Unable to save file! (%1)")
+                      .arg(file.errorString()));
   }
 
-  // (2) Create XML //////////////////////////////////////////////////////////
-
-  const QString xmlContent = xmlWrite(context, parent);
-
-  // (3) Serialize XML ///////////////////////////////////////////////////////
-
-  QTextStream stream(&file);
-  stream.setCodec("UTF-8");
-  stream << xmlContent;
-  stream.flush();
+  // (2) Write file //////////////////////////////////////////////////////////
+
+  XmlFragments written;
+
+  bool ok{false};
+  if(        isBinaryFile(filename) ) {
+    ok = binWrite(&file, context, error);
+  } else if( isCompressedFile(filename) ) {
+    CompressDevice device(&file);
+    ok =
+        device.open(QIODevice::WriteOnly)           &&
+        xmlWrite(&device, context, error, &written) &&
+        device.finish();
+  } else {
+    ok = xmlWrite(&file, context, error, &written);
+  }
+  if( !ok ) {
+    file.cancelWriting();
+    if( error != nullptr  &&  !error->isError() ) {
+      setIoError(error, IoError::WriteError,
+                 QCoreApplication::translate(TR_CTX, "Unable to write compressed data! (%1)")
+                 .arg(file.errorString()));
+    }
+    return false;
+  }
 
   // Done! ///////////////////////////////////////////////////////////////////
 
-  file.close();
+  if( !file.commit() ) {
+    return setIoError(error, IoError::WriteError,
+                      QCoreApplication::translate(TR_CTX, "Unable to save file! (%1)")
+                      .arg(file.errorString()));
+  }
+
+  if( fragments != nullptr ) {
+    *fragments = std::move(written);
+  }
 
   return true;
 }
@@ -0,0 +1,95 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+
+#include <QtCore/QString>
+
+#include "Format.h"
+
+namespace Format {
+
+  ////// Public //////////////////////////////////////////////////////////////
+
+  char *toChars(char *first, char *last, const numhour_t hours)
+  {
+    // (1) Magnitude in centi-hours //////////////////////////////////////////
+
+    const long long value = hours.centi();
+
+    unsigned long long u = value < 0
+        ? 0ULL - static_cast<unsigned long long>(value)
+        : static_cast<unsigned long long>(value);
+
+    // (2) Format right-to-left //////////////////////////////////////////////
+
+    char buffer[HOURS_SIZE];
+    char *p = buffer + HOURS_SIZE;
+
+    *--p = char('0' + u%10);
+    u /= 10;
+    *--p = char('0' + u%10);
+    u /= 10;
+    *--p = '.';
+    do {
+      *--p = char('0' + u%10);
+      u /= 10;
+    } while( u != 0 );
+    if( value < 0 ) {
+      *--p = '-';
+    }
+
+    // (3) Copy //////////////////////////////////////////////////////////////
+
+    const std::ptrdiff_t size = buffer + HOURS_SIZE - p;
+    if( last - first < size ) {
+      return nullptr;
+    }
+
+    return std::copy(p, buffer + HOURS_SIZE, first);
+  }
+
+  void toString(QString& buffer, const numhour_t hours)
+  {
+    char chars[HOURS_SIZE];
+
+    const char *end = toChars(chars, chars + HOURS_SIZE, hours);
+
+    const int size = int(end - chars);
+    buffer.resize(size);
+
+    QChar *data = buffer.data();
+    for(int i = 0; i < size; i++) {
+      data[i] = QLatin1Char(chars[i]);
+    }
+  }
+
+} // namespace Format
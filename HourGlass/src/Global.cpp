@@ -34,3 +34,4 @@
 ////// Public ////////////////////////////////////////////////////////////////
 
 Context global;
+Journal journal;
@@ -0,0 +1,345 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// NOTE: AVX2 is opt-in; cf. HOURGLASS_ENABLE_AVX2.
+#if defined(__AVX2__)
+# include <immintrin.h>
+#elif defined(__SSE2__)  ||  defined(_M_X64)  ||  (defined(_M_IX86_FP)  &&  _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define HAVE_SSE2
+#endif
+
+#include "Hours.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  constexpr std::size_t NUM_HOURS = NUM_DAYS;
+
+#if defined(__AVX2__)
+  constexpr std::size_t LANES = 8;
+
+  using vector_t = __m256i;
+
+  inline vector_t load(const numhour_t *p)
+  {
+    return _mm256_loadu_si256(reinterpret_cast<const vector_t*>(p));
+  }
+
+  inline void store(numhour_t *p, const vector_t v)
+  {
+    _mm256_storeu_si256(reinterpret_cast<vector_t*>(p), v);
+  }
+
+  inline vector_t add(const vector_t a, const vector_t b)
+  {
+    return _mm256_add_epi32(a, b);
+  }
+
+  inline vector_t zero()
+  {
+    return _mm256_setzero_si256();
+  }
+
+  inline numhour_t::value_type horizontalSum(const vector_t v)
+  {
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+  }
+#elif defined(HAVE_SSE2)
+  constexpr std::size_t LANES = 4;
+
+  using vector_t = __m128i;
+
+  inline vector_t load(const numhour_t *p)
+  {
+    return _mm_loadu_si128(reinterpret_cast<const vector_t*>(p));
+  }
+
+  inline void store(numhour_t *p, const vector_t v)
+  {
+    _mm_storeu_si128(reinterpret_cast<vector_t*>(p), v);
+  }
+
+  inline vector_t add(const vector_t a, const vector_t b)
+  {
+    return _mm_add_epi32(a, b);
+  }
+
+  inline vector_t zero()
+  {
+    return _mm_setzero_si128();
+  }
+
+  inline numhour_t::value_type horizontalSum(const vector_t v)
+  {
+    __m128i s = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+  }
+#else
+  constexpr std::size_t LANES = 1; // Scalar
+#endif
+
+  // Hours handled by the vectorized part of a kernel
+  constexpr std::size_t NUM_VECTOR = NUM_HOURS/LANES*LANES;
+
+} // namespace priv
+
+////// public ////////////////////////////////////////////////////////////////
+
+bool numhour_t::fromDouble(numhour_t& result, const double hours)
+{
+  constexpr double MIN = std::numeric_limits<value_type>::lowest();
+  constexpr double MAX = std::numeric_limits<value_type>::max();
+
+  const double centi = std::round(hours*double(SCALE));
+  if( !std::isfinite(centi)  ||  centi < MIN  ||  centi > MAX ) {
+    return false;
+  }
+
+  result = fromCenti(value_type(centi));
+
+  return true;
+}
+
+Hours::Hours(const HoursArray& hours)
+{
+  for(std::size_t day = 0; day < NUM_DAYS; day++) {
+    set(day, hours[day]);
+  }
+}
+
+Hours::Hours(const Hours& other)
+  : _mask{other._mask}
+  , _values(other._values)
+{
+  if( other._dense ) {
+    _dense = std::make_unique<HoursArray>(*other._dense);
+  }
+}
+
+Hours& Hours::operator=(const Hours& other)
+{
+  if( this != &other ) {
+    Hours copy(other);
+    *this = std::move(copy);
+  }
+
+  return *this;
+}
+
+numhour_t Hours::operator[](const std::size_t day) const
+{
+  if( day >= NUM_DAYS ) {
+    return numhour_t{0};
+  }
+
+  if( _dense ) {
+    return (*_dense)[day];
+  }
+
+  return (_mask & (std::uint32_t{1} << day)) != 0
+      ? _values[index(day)]
+      : numhour_t{0};
+}
+
+bool Hours::isDense() const
+{
+  return bool(_dense);
+}
+
+bool Hours::isEmpty() const
+{
+  if( _dense ) {
+    return std::all_of(_dense->cbegin(), _dense->cend(), [](const numhour_t& h) -> bool {
+      return h == numhour_t{0};
+    });
+  }
+
+  return _mask == 0;
+}
+
+void Hours::set(const std::size_t day, const numhour_t hours)
+{
+  if( day >= NUM_DAYS ) {
+    return;
+  }
+
+  if( _dense ) {
+    (*_dense)[day] = hours;
+    return;
+  }
+
+  const std::uint32_t bit   = std::uint32_t{1} << day;
+  const std::size_t   i     = index(day);
+  const std::size_t   count = std::size_t(std::popcount(_mask));
+
+  // (1) Update or remove a booked day ///////////////////////////////////////
+
+  if( (_mask & bit) != 0 ) {
+    if( hours != numhour_t{0} ) {
+      _values[i] = hours;
+    } else {
+      std::copy(_values.begin() + i + 1, _values.begin() + count, _values.begin() + i);
+      _values[count - 1] = numhour_t{0};
+      _mask &= ~bit;
+    }
+    return;
+  }
+
+  if( hours == numhour_t{0} ) {
+    return;
+  }
+
+  // (2) Book a new day //////////////////////////////////////////////////////
+
+  if( count >= SPARSE_SIZE ) {
+    makeDense();
+    (*_dense)[day] = hours;
+    return;
+  }
+
+  std::copy_backward(_values.begin() + i, _values.begin() + count,
+                     _values.begin() + count + 1);
+  _values[i] = hours;
+  _mask |= bit;
+}
+
+void Hours::addTo(HoursArray& sum) const
+{
+  if( _dense ) {
+    addHours(sum, *_dense);
+    return;
+  }
+
+  forEachDay([&](const std::size_t day, const numhour_t hours) -> void {
+    sum[day] += hours;
+  });
+}
+
+numhour_t Hours::sum() const
+{
+  if( _dense ) {
+    return sumHours(*_dense);
+  }
+
+  numhour_t result{0};
+  for(const numhour_t& hours : _values) { // unused values are zero
+    result += hours;
+  }
+
+  return result;
+}
+
+HoursArray Hours::toArray() const
+{
+  if( _dense ) {
+    return *_dense;
+  }
+
+  HoursArray result;
+  addTo(result);
+
+  return result;
+}
+
+bool operator==(const Hours& lhs, const Hours& rhs)
+{
+  if( !lhs._dense  &&  !rhs._dense ) {
+    return lhs._mask == rhs._mask  &&  lhs._values == rhs._values;
+  }
+
+  return lhs.toArray() == rhs.toArray();
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+std::size_t Hours::index(const std::size_t day) const
+{
+  const std::uint32_t below = (std::uint32_t{1} << day) - 1;
+  return std::size_t(std::popcount(_mask & below));
+}
+
+void Hours::makeDense()
+{
+  auto dense = std::make_unique<HoursArray>();
+  addTo(*dense);
+
+  _dense = std::move(dense);
+  _mask  = 0;
+  _values.fill(numhour_t{0});
+}
+
+////// Public ////////////////////////////////////////////////////////////////
+
+void addHours(HoursArray& sum, const HoursArray& hours)
+{
+  std::size_t i = 0;
+
+#if defined(__AVX2__)  ||  defined(HAVE_SSE2)
+  for(; i < priv::NUM_VECTOR; i += priv::LANES) {
+    priv::store(sum.data() + i, priv::add(priv::load(sum.data() + i),
+                                          priv::load(hours.data() + i)));
+  }
+#endif
+
+  for(; i < priv::NUM_HOURS; i++) {
+    sum[i] += hours[i];
+  }
+}
+
+numhour_t sumHours(const HoursArray& hours)
+{
+  numhour_t result{0};
+  std::size_t i = 0;
+
+#if defined(__AVX2__)  ||  defined(HAVE_SSE2)
+  priv::vector_t acc = priv::zero();
+  for(; i < priv::NUM_VECTOR; i += priv::LANES) {
+    acc = priv::add(acc, priv::load(hours.data() + i));
+  }
+  result = numhour_t::fromCenti(priv::horizontalSum(acc));
+#endif
+
+  for(; i < priv::NUM_HOURS; i++) {
+    result += hours[i];
+  }
+
+  return result;
+}
@@ -0,0 +1,148 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <utility>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QRunnable>
+
+#include "HoursWriter.h"
+
+#include "Backup_io.h"
+#include "File_io.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  class WriteTask : public QRunnable {
+  public:
+    WriteTask(HoursWriter *writer, const QString& filename,
+              const Context *snapshot, IoError *error, XmlFragments *fragments,
+              const bool backup) noexcept
+      : _writer{writer}
+      , _filename(filename)
+      , _snapshot{snapshot}
+      , _error{error}
+      , _fragments{fragments}
+      , _backup{backup}
+    {
+    }
+
+    void run() final
+    {
+      if( _backup ) {
+        backupHoursFile(_filename);
+      }
+
+      const bool ok = writeHoursFile(_filename, *_snapshot, _error, _fragments);
+
+      QMetaObject::invokeMethod(_writer, "finishWrite", Qt::QueuedConnection,
+                                Q_ARG(QString, _filename),
+                                Q_ARG(bool, ok));
+    }
+
+  private:
+    HoursWriter *_writer{nullptr};
+    QString _filename;
+    const Context *_snapshot{nullptr};
+    IoError *_error{nullptr};
+    XmlFragments *_fragments{nullptr};
+    bool _backup{false};
+  };
+
+} // namespace priv
+
+////// public ////////////////////////////////////////////////////////////////
+
+HoursWriter::HoursWriter(QObject *parent)
+  : QObject(parent)
+{
+  _pool.setMaxThreadCount(1);
+}
+
+HoursWriter::~HoursWriter()
+{
+  _pool.waitForDone();
+}
+
+const IoError& HoursWriter::error() const
+{
+  return _error;
+}
+
+XmlFragments HoursWriter::takeFragments()
+{
+  return std::exchange(_fragments, XmlFragments());
+}
+
+bool HoursWriter::isRunning() const
+{
+  return _is_running;
+}
+
+const Context& HoursWriter::snapshot() const
+{
+  return _snapshot;
+}
+
+bool HoursWriter::start(const QString& filename, const Context& context, const bool backup)
+{
+  if( _is_running  ||  filename.isEmpty() ) {
+    return false;
+  }
+
+  // NOTE: Only the modified months are deep copied on the calling thread;
+  //       the fragments and the projects' strings are implicitly shared.
+  _snapshot = context.snapshot();
+
+  _fragments = XmlFragments();
+
+  _is_running = true;
+  _pool.start(new priv::WriteTask(this, filename, &_snapshot, &_error, &_fragments, backup));
+
+  return true;
+}
+
+void HoursWriter::wait()
+{
+  _pool.waitForDone();
+  QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+}
+
+////// private slots /////////////////////////////////////////////////////////
+
+void HoursWriter::finishWrite(const QString& filename, const bool ok)
+{
+  _is_running = false;
+
+  emit finished(filename, ok);
+}
@@ -0,0 +1,78 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <utility>
+
+#include <QtCore/QFileInfo>
+
+#include "IoError.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+IoError::IoError(const Code code, const QString& message,
+                 const qint64 line, const qint64 column) noexcept
+  : code{code}
+  , line{line}
+  , column{column}
+  , message(message)
+{
+}
+
+bool IoError::isError() const
+{
+  return code != NoError;
+}
+
+QString IoError::toString() const
+{
+  QString location = QFileInfo(filename).fileName();
+  if( line > 0 ) {
+    location += QStringLiteral("(%1,%2)").arg(line).arg(column);
+  }
+
+  return !location.isEmpty()
+      ? QStringLiteral("%1: %2").arg(location, message)
+      : message;
+}
+
+////// Public ////////////////////////////////////////////////////////////////
+
+bool setIoError(IoError *error, const IoError::Code code, const QString& message,
+                const qint64 line, const qint64 column)
+{
+  if( error != nullptr ) {
+    const QString filename = std::move(error->filename);
+    *error = IoError(code, message, line, column);
+    error->filename = filename;
+  }
+
+  return false;
+}
@@ -29,8 +29,6 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
-#include <numeric>
-
 #include "Item.h"
 
 ////// public ////////////////////////////////////////////////////////////////
@@ -40,7 +38,6 @@ Item::Item(const projectid_t projectId,
   : activity(activity)
   , projectId{projectId}
 {
-  hours.fill(0);
 }
 
 bool Item::isValid() const
@@ -50,6 +47,5 @@ bool Item::isValid() const
 
 numhour_t Item::sumHours() const
 {
-  return std::accumulate(hours.cbegin(), hours.cend(),
-                         numhour_t{0});
+  return hours.sum();
 }
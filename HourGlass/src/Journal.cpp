@@ -0,0 +1,485 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <QtCore/QDataStream>
+#include <QtCore/QSaveFile>
+
+#include "Journal.h"
+
+#include "Context.h"
+
+////// Macros ////////////////////////////////////////////////////////////////
+
+#define JOURNAL_SUFFIX  QStringLiteral(".journal")
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  constexpr char    JOURNAL_MAGIC[4] = {'H', 'G', 'J', 'L'};
+  constexpr quint16 JOURNAL_VERSION  = 1;
+  constexpr qint64  JOURNAL_HEADER   = sizeof(JOURNAL_MAGIC) + sizeof(JOURNAL_VERSION);
+
+  enum Record : quint8 {
+    AddItem = 1,
+    AddMonth,
+    AddProject,
+    SetActivity,
+    SetHours,
+    SetItemProject,
+    SetProjectAnnotation,
+    SetProjectName
+  };
+
+  inline void initializeStream(QDataStream& stream)
+  {
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setVersion(QDataStream::Qt_5_12);
+  }
+
+  QByteArray header()
+  {
+    QByteArray result;
+
+    QDataStream stream(&result, QIODevice::WriteOnly);
+    initializeStream(stream);
+
+    stream.writeRawData(JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    stream << JOURNAL_VERSION;
+
+    return result;
+  }
+
+  template<typename FUNC>
+  QByteArray record(const Record type, FUNC&& func)
+  {
+    QByteArray result;
+
+    QDataStream stream(&result, QIODevice::WriteOnly);
+    initializeStream(stream);
+
+    stream << quint8(type);
+    func(stream);
+
+    return result;
+  }
+
+  Item *findItem(Context& context, const qint32 mid, const quint32 row)
+  {
+    Month *m = context.findMonth(mid);
+    if( m == nullptr  ||  row >= m->items.size() ) {
+      return nullptr;
+    }
+
+    return &m->items[row];
+  }
+
+  // NOTE: Records are absolute, i.e. replaying them on top of a file,
+  //       which already contains them, does not alter the file's content.
+  bool replayRecord(Context& context, QDataStream& stream)
+  {
+    quint8 type{0};
+    stream >> type;
+
+    qint32  mid;
+    quint32 pid;
+    quint32 row;
+    QString text;
+
+    if(        type == AddItem ) {
+      stream >> mid >> row >> pid;
+      if( stream.status() != QDataStream::Ok ) {
+        return false;
+      }
+
+      Month *m = context.findMonth(mid);
+      if( m == nullptr  ||  row > m->items.size()  ||  !context.isProject(pid) ) {
+        return false;
+      }
+
+      if( row == m->items.size() ) {
+        m->add(Item(pid));
+      }
+      context.setMonthModified(mid);
+
+    } else if( type == AddMonth ) {
+      stream >> mid;
+      if( stream.status() != QDataStream::Ok ) {
+        return false;
+      }
+
+      if( !context.isMonth(mid) ) {
+        const SplitId split = split_monthid(mid);
+        if( !context.add(Month(split.first, split.second)) ) {
+          return false;
+        }
+      }
+
+    } else if( type == AddProject ) {
+      QString annotation;
+      stream >> pid >> text >> annotation;
+      if( stream.status() != QDataStream::Ok ) {
+        return false;
+      }
+
+      if( !context.isProject(pid)  &&  !context.add(Project(pid, text, annotation)) ) {
+        return false;
+      }
+
+    } else if( type == SetActivity ) {
+      stream >> mid >> row >> text;
+      if( stream.status() != QDataStream::Ok ) {
+        return false;
+      }
+
+      Item *item = findItem(context, mid, row);
+      if( item == nullptr ) {
+        return false;
+      }
+
+      item->activity = text;
+      context.setMonthModified(mid);
+
+    } else if( type == SetHours ) {
+      quint8 day;
+      double value;
+      stream >> mid >> row >> day >> value;
+      if( stream.status() != QDataStream::Ok ) {
+        return false;
+      }
+
+      numhour_t hours;
+      if( !numhour_t::fromDouble(hours, value) ) {
+        return false;
+      }
+
+      Month *m = context.findMonth(mid);
+      if( m == nullptr  ||  row >= m->items.size()  ||  day >= Hours::size() ) {
+        return false;
+      }
+
+      m->setHours(row, day, hours);
+      context.setMonthModified(mid);
+
+    } else if( type == SetItemProject ) {
+      stream >> mid >> row >> pid;
+      if( stream.status() != QDataStream::Ok ) {
+        return false;
+      }
+
+      Item *item = findItem(context, mid, row);
+      if( item == nullptr  ||  !context.isProject(pid) ) {
+        return false;
+      }
+
+      item->projectId = pid;
+      context.setMonthModified(mid);
+
+    } else if( type == SetProjectAnnotation  ||  type == SetProjectName ) {
+      stream >> pid >> text;
+      if( stream.status() != QDataStream::Ok ) {
+        return false;
+      }
+
+      Project *p = context.findProject(pid);
+      if( p == nullptr ) {
+        return false;
+      }
+
+      if( type == SetProjectName ) {
+        p->name = text;
+      } else {
+        p->annotation = text;
+      }
+      context.setProjectModified(pid);
+
+    } else {
+      return false;
+    }
+
+    return true;
+  }
+
+} // namespace priv
+
+////// public ////////////////////////////////////////////////////////////////
+
+Journal::Journal() noexcept
+{
+}
+
+Journal::~Journal()
+{
+  close();
+}
+
+bool Journal::isEmpty() const
+{
+  return size() <= priv::JOURNAL_HEADER;
+}
+
+bool Journal::isOpen() const
+{
+  return _file.isOpen();
+}
+
+qint64 Journal::size() const
+{
+  return _file.isOpen()
+      ? _file.size()
+      : 0;
+}
+
+void Journal::close()
+{
+  _file.close();
+}
+
+bool Journal::open(const QString& filename)
+{
+  close();
+
+  _file.setFileName(journalName(filename));
+  if( !_file.open(QIODevice::ReadWrite) ) {
+    return false;
+  }
+
+  // NOTE: Existing records are kept until they are folded into "filename".
+  const QByteArray header = priv::header();
+  if( _file.read(header.size()) != header ) {
+    return clear();
+  }
+
+  return _file.seek(_file.size());
+}
+
+void Journal::setFailureHandler(FailureHandler handler)
+{
+  _failureHandler = std::move(handler);
+}
+
+bool Journal::clear()
+{
+  return rewrite(QByteArray());
+}
+
+bool Journal::discard(const qint64 size)
+{
+  if( !_file.isOpen() ) {
+    return false;
+  }
+
+  if( size <= priv::JOURNAL_HEADER ) {
+    return true; // nothing to discard!
+  }
+
+  if( size >= _file.size() ) {
+    return clear();
+  }
+
+  if( !_file.seek(size) ) {
+    return false;
+  }
+  const QByteArray records = _file.readAll();
+
+  return rewrite(records);
+}
+
+bool Journal::moveTo(const QString& filename)
+{
+  if( !_file.isOpen() ) {
+    return false;
+  }
+
+  const QString name = journalName(filename);
+  if( name == _file.fileName() ) {
+    return true;
+  }
+
+  _file.close();
+
+  QFile::remove(name);
+  const bool ok = _file.rename(name);
+
+  if( !_file.open(QIODevice::ReadWrite) ) {
+    if( _failureHandler ) {
+      _failureHandler(_file.errorString());
+    }
+    return false;
+  }
+
+  return _file.seek(_file.size())  &&  ok;
+}
+
+void Journal::addItem(const monthid_t mid, const std::size_t row, const projectid_t pid)
+{
+  append(priv::record(priv::AddItem, [&](QDataStream& stream) -> void {
+    stream << qint32(mid) << quint32(row) << quint32(pid);
+  }));
+}
+
+void Journal::addMonth(const monthid_t mid)
+{
+  append(priv::record(priv::AddMonth, [&](QDataStream& stream) -> void {
+    stream << qint32(mid);
+  }));
+}
+
+void Journal::addProject(const Project& project)
+{
+  append(priv::record(priv::AddProject, [&](QDataStream& stream) -> void {
+    stream << quint32(project.id()) << project.name << project.annotation;
+  }));
+}
+
+void Journal::setActivity(const monthid_t mid, const std::size_t row, const QString& activity)
+{
+  append(priv::record(priv::SetActivity, [&](QDataStream& stream) -> void {
+    stream << qint32(mid) << quint32(row) << activity;
+  }));
+}
+
+void Journal::setHours(const monthid_t mid, const std::size_t row, const std::size_t day,
+                       const numhour_t hours)
+{
+  append(priv::record(priv::SetHours, [&](QDataStream& stream) -> void {
+    stream << qint32(mid) << quint32(row) << quint8(day) << hours.toDouble();
+  }));
+}
+
+void Journal::setItemProject(const monthid_t mid, const std::size_t row, const projectid_t pid)
+{
+  append(priv::record(priv::SetItemProject, [&](QDataStream& stream) -> void {
+    stream << qint32(mid) << quint32(row) << quint32(pid);
+  }));
+}
+
+void Journal::setProjectAnnotation(const projectid_t pid, const QString& annotation)
+{
+  append(priv::record(priv::SetProjectAnnotation, [&](QDataStream& stream) -> void {
+    stream << quint32(pid) << annotation;
+  }));
+}
+
+void Journal::setProjectName(const projectid_t pid, const QString& name)
+{
+  append(priv::record(priv::SetProjectName, [&](QDataStream& stream) -> void {
+    stream << quint32(pid) << name;
+  }));
+}
+
+QString Journal::journalName(const QString& filename)
+{
+  return filename + JOURNAL_SUFFIX;
+}
+
+std::size_t Journal::replay(Context& context, const QString& filename)
+{
+  QFile file(journalName(filename));
+  if( !file.open(QIODevice::ReadOnly) ) {
+    return 0;
+  }
+
+  const QByteArray content = file.readAll();
+  file.close();
+
+  const QByteArray header = priv::header();
+  if( !content.startsWith(header) ) {
+    return 0;
+  }
+
+  QDataStream stream(content);
+  priv::initializeStream(stream);
+  stream.skipRawData(header.size());
+
+  // NOTE: A truncated trailing record stops the replay.
+  std::size_t numRecords = 0;
+  while( !stream.atEnd()  &&  priv::replayRecord(context, stream) ) {
+    numRecords++;
+  }
+
+  return numRecords;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+void Journal::append(const QByteArray& record)
+{
+  if( !_file.isOpen() ) {
+    return;
+  }
+
+  // NOTE: One write per record keeps a crash from interleaving records.
+  if( _file.write(record) == record.size()  &&  _file.flush() ) {
+    return;
+  }
+
+  // NOTE: Further records would not be replayable without this one.
+  const QString error = _file.errorString();
+  close();
+
+  if( _failureHandler ) {
+    _failureHandler(error);
+  }
+}
+
+bool Journal::rewrite(const QByteArray& records)
+{
+  if( !_file.isOpen() ) {
+    return false;
+  }
+
+  // NOTE: The journal is replaced atomically, i.e. a failure or crash
+  //       leaves the previous journal intact.
+  QSaveFile file(_file.fileName());
+  if( !file.open(QIODevice::WriteOnly) ) {
+    return false;
+  }
+
+  const QByteArray header = priv::header();
+  if( file.write(header) != header.size()  ||  file.write(records) != records.size() ) {
+    file.cancelWriting();
+    return false;
+  }
+
+  // NOTE: Some platforms refuse to replace an open file.
+  _file.close();
+  const bool ok = file.commit();
+
+  if( !_file.open(QIODevice::ReadWrite) ) {
+    if( _failureHandler ) {
+      _failureHandler(_file.errorString());
+    }
+    return false;
+  }
+
+  return _file.seek(_file.size())  &&  ok;
+}
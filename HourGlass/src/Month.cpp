@@ -39,6 +39,7 @@
 Month::Month(const int year, const int month) noexcept
   : _month{month}
   , _year{year}
+  , _calendar{Calendar::makeTable(year, month)}
 {
 }
 
@@ -47,12 +48,13 @@ Month::Month(const QDate& date) noexcept
   if( date.isValid() ) {
     _year = date.year();
     _month = date.month();
+    _calendar = Calendar::makeTable(_year, _month);
   }
 }
 
 bool Month::isValid() const
 {
-  return QDate::isValid(_year, _month, 1);
+  return _calendar.days > 0;
 }
 
 monthid_t Month::id() const
@@ -68,6 +70,13 @@ bool Month::add(Item i)
     return false;
   }
 
+  if( _totals.is_valid ) {
+    const numhour_t sum = i.sumHours();
+    i.hours.addTo(_totals.days);
+    _totals.items.push_back(sum);
+    _totals.month += sum;
+  }
+
   items.push_back(std::move(i));
 
   return true;
@@ -75,17 +84,12 @@ bool Month::add(Item i)
 
 int Month::days() const
 {
-  return QDate(_year, _month, 1).daysInMonth();
-}
-
-bool Month::isCurrentDay(const int day) const
-{
-  return QDate(_year, _month, day) == QDate::currentDate();
+  return _calendar.days;
 }
 
 bool Month::isMonday(const int day) const
 {
-  return QDate(_year, _month, day).dayOfWeek() == Qt::Monday;
+  return calendarDay(day).weekDay == Qt::Monday;
 }
 
 bool Month::isMonth(const QDate& date) const
@@ -95,23 +99,53 @@ bool Month::isMonth(const QDate& date) const
 
 bool Month::isWeekend(const int day) const
 {
-  const int weekDay = QDate(_year, _month, day).dayOfWeek();
+  return calendarDay(day).is_weekend;
+}
+
+void Month::setHours(const std::size_t row, const std::size_t day, const numhour_t hours)
+{
+  if( row >= items.size()  ||  day >= Hours::size() ) {
+    return;
+  }
 
-  return weekDay == Qt::Saturday  ||  weekDay == Qt::Sunday;
+  Hours& cells = items[row].hours;
+
+  if( _totals.is_valid ) {
+    const numhour_t delta = hours - cells[day];
+    _totals.days[day]   += delta;
+    _totals.items[row]  += delta;
+    _totals.month       += delta;
+  }
+
+  cells.set(day, hours);
 }
 
 numhour_t Month::sumDayHours(const std::size_t day) const
 {
-  if( day >= Hours().size() ) {
-    return 0;
+  if( day >= Hours::size() ) {
+    return numhour_t{0};
   }
 
-  numhour_t result = 0;
-  for(const Item& item : items) {
-    result += item.hours[day];
+  return totals().days[day];
+}
+
+HoursArray Month::sumDayHours() const
+{
+  return totals().days;
+}
+
+numhour_t Month::sumHours() const
+{
+  return totals().month;
+}
+
+numhour_t Month::sumItemHours(const std::size_t row) const
+{
+  if( row >= items.size() ) {
+    return numhour_t{0};
   }
 
-  return result;
+  return totals().items[row];
 }
 
 QString Month::toLocaleString() const
@@ -129,7 +163,60 @@ QString Month::toString() const
 
 int Month::weekNumber(const int day) const
 {
-  return QDate(_year, _month, day).weekNumber();
+  return calendarDay(day).week;
+}
+
+void Month::invalidateTotals()
+{
+  _totals = Totals();
+}
+
+bool Month::isTotalsValid() const
+{
+  if( !_totals.is_valid ) {
+    return true; // Rebuilt on next access
+  }
+
+  const Totals expected = computeTotals(items);
+
+  return _totals.days == expected.days  &&
+      _totals.items == expected.items  &&
+      _totals.month == expected.month;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+const Calendar::Day& Month::calendarDay(const int day) const
+{
+  static const Calendar::Day INVALID_DAY;
+
+  return 1 <= day  &&  day <= _calendar.days
+      ? _calendar.day[std::size_t(day - 1)]
+      : INVALID_DAY;
+}
+
+Month::Totals Month::computeTotals(const Items& items)
+{
+  Totals result;
+
+  result.items.reserve(items.size());
+  for(const Item& item : items) {
+    item.hours.addTo(result.days);
+    result.items.push_back(item.sumHours());
+  }
+  result.month    = ::sumHours(result.days);
+  result.is_valid = true;
+
+  return result;
+}
+
+const Month::Totals& Month::totals() const
+{
+  if( !_totals.is_valid  ||  _totals.items.size() != items.size() ) {
+    _totals = computeTotals(items);
+  }
+
+  return _totals;
 }
 
 ////// Public ////////////////////////////////////////////////////////////////
@@ -143,3 +230,14 @@ SplitId split_monthid(const monthid_t id)
 {
   return SplitId(id/100, id%100);
 }
+
+monthord_t to_monthord(const monthid_t id)
+{
+  const SplitId sid = split_monthid(id);
+  return sid.first*12 + sid.second - 1;
+}
+
+monthid_t from_monthord(const monthord_t ord)
+{
+  return make_monthid(ord/12, ord%12 + 1);
+}
@@ -29,8 +29,9 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
-#include <QtCore/QDate>
+#include <QtCore/QDateTime>
 #include <QtCore/QLocale>
+#include <QtCore/QTimer>
 #include <QtGui/QBrush>
 
 #include "MonthModel.h"
@@ -43,16 +44,8 @@
 
 namespace priv {
 
-  numhour_t sum(const Month& month)
-  {
-    auto lambda_sum = [](const numhour_t& lhs, const Item& rhs) -> numhour_t
-    {
-      return lhs + rhs.sumHours();
-    };
-
-    return std::accumulate(month.items.cbegin(), month.items.cend(),
-                           numhour_t{0}, lambda_sum);
-  }
+  // NOTE: Safety margin to not wake up just before midnight.
+  constexpr qint64 MIDNIGHT_MARGIN = 1000; // [ms]
 
 } // namespace priv
 
@@ -61,6 +54,12 @@ namespace priv {
 MonthModel::MonthModel(QObject *parent)
   : QAbstractTableModel(parent)
 {
+  _midnightTimer = new QTimer(this);
+  _midnightTimer->setSingleShot(true);
+  _midnightTimer->setTimerType(Qt::VeryCoarseTimer);
+
+  connect(_midnightTimer, &QTimer::timeout,
+          this, &MonthModel::updateCurrentDay);
 }
 
 MonthModel::~MonthModel()
@@ -82,7 +81,8 @@ void MonthModel::addItem(const projectid_t id)
   _month->add(Item(p->id()));
   endInsertRows();
 
-  global.setModified();
+  global.setMonthModified(_month->id());
+  journal.addItem(_month->id(), _month->items.size() - 1, p->id());
 }
 
 void MonthModel::clearMonth()
@@ -132,10 +132,19 @@ void MonthModel::setMonth(Month *month)
     return;
   }
 
+  // NOTE: Totals are maintained by setHours(); cf. setData().
+  Q_ASSERT( month == nullptr  ||  month->isTotalsValid() );
+
   beginResetModel();
   _month = month;
+  // NOTE: Determined once per reset & at midnight; cf. updateCurrentDay().
+  _currentDay = isCurrentMonth()
+      ? QDate::currentDate().day()
+      : 0;
   endResetModel();
 
+  startMidnightTimer();
+
   if( month != nullptr ) {
     emit monthChanged(_month->toLocaleString());
   } else {
@@ -182,7 +191,7 @@ QVariant MonthModel::data(const QModelIndex& index,
       } else if( column == COL_Activity ) {
         return item.activity;
       } else if( column == COL_Hours ) {
-        return View::toString(item.sumHours());
+        return View::toString(_month->sumItemHours(size_type(row)));
       } else if( isDayColumn(column) ) {
         return View::toString(item.hours[column - Num_ItemColumns], true);
       }
@@ -191,7 +200,7 @@ QVariant MonthModel::data(const QModelIndex& index,
       if(        column == COL_Activity ) {
         return tr("Sum");
       } else if( column == COL_Hours ) {
-        return View::toString(priv::sum(*_month));
+        return View::toString(_month->sumHours());
       } else if( isDayColumn(column) ) {
         return View::toString(_month->sumDayHours(column - Num_ItemColumns));
       }
@@ -295,7 +304,7 @@ QVariant MonthModel::headerData(int section, Qt::Orientation orientation,
           return QStringLiteral("[%1] %2")
               .arg(_month->weekNumber(day), 2, 10, QLatin1Char('0'))
               .arg(day);
-        } else if( _month->isCurrentDay(day) ) {
+        } else if( day == _currentDay ) {
           return QStringLiteral(">%1<")
               .arg(day);
         } else {
@@ -305,7 +314,7 @@ QVariant MonthModel::headerData(int section, Qt::Orientation orientation,
 
     } else if( role == Qt::ForegroundRole ) {
       if( isDayColumn(section) ) {
-        if( _month->isCurrentDay(day(section)) ) {
+        if( day(section) == _currentDay ) {
           return QBrush(Qt::red);
         }
       }
@@ -360,7 +369,8 @@ bool MonthModel::setData(const QModelIndex& index, const QVariant& value,
         emit dataChanged(index, index);
         emit headerDataChanged(Qt::Vertical, row, row);
 
-        global.setModified();
+        global.setMonthModified(_month->id());
+        journal.setItemProject(_month->id(), size_type(row), item.projectId);
 
         return true;
 
@@ -369,12 +379,19 @@ bool MonthModel::setData(const QModelIndex& index, const QVariant& value,
 
         emit dataChanged(index, index);
 
-        global.setModified();
+        global.setMonthModified(_month->id());
+        journal.setActivity(_month->id(), size_type(row), item.activity);
 
         return true;
 
       } else if( isDayColumn(column) ) {
-        item.hours[column - Num_ItemColumns] = View::toDouble(value.toString());
+        const size_type day = size_type(column - Num_ItemColumns);
+
+        numhour_t hours;
+        if( !View::toHours(hours, value.toString()) ) {
+          return false;
+        }
+        _month->setHours(size_type(row), day, hours);
 
         emit dataChanged(index, index);
 
@@ -387,7 +404,8 @@ bool MonthModel::setData(const QModelIndex& index, const QVariant& value,
         const QModelIndex dayHoursIdx = MonthModel::index(rowCount() - 1, column);
         emit dataChanged(dayHoursIdx, dayHoursIdx);
 
-        global.setModified();
+        global.setMonthModified(_month->id());
+        journal.setHours(_month->id(), size_type(row), day, item.hours[day]);
 
         return true;
 
@@ -409,6 +427,24 @@ void MonthModel::setShowProjectRow(const bool on)
   emit headerDataChanged(Qt::Vertical, 0, rowCount() - 1);
 }
 
+////// private slots /////////////////////////////////////////////////////////
+
+void MonthModel::updateCurrentDay()
+{
+  const int currentDay = isCurrentMonth()
+      ? QDate::currentDate().day()
+      : 0;
+
+  startMidnightTimer();
+
+  if( currentDay == _currentDay ) {
+    return;
+  }
+
+  _currentDay = currentDay;
+  emit headerDataChanged(Qt::Horizontal, Num_ItemColumns, columnCount() - 1);
+}
+
 ////// private ///////////////////////////////////////////////////////////////
 
 bool MonthModel::isDayHoursRow(const int row) const
@@ -420,3 +456,16 @@ bool MonthModel::isItemRow(const int row) const
 {
   return 0 <= row  &&  size_type(row) < _month->items.size();
 }
+
+void MonthModel::startMidnightTimer()
+{
+  if( !isValid() ) {
+    _midnightTimer->stop();
+    return;
+  }
+
+  const QDateTime now = QDateTime::currentDateTime();
+  const QDateTime midnight(now.date().addDays(1), QTime(0, 0));
+
+  _midnightTimer->start(int(now.msecsTo(midnight) + priv::MIDNIGHT_MARGIN));
+}
@@ -0,0 +1,147 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <charconv>
+#include <version>
+
+#include <QtCore/QByteArray>
+
+#include "Parse.h"
+
+namespace Parse {
+
+  ////// Private /////////////////////////////////////////////////////////////
+
+  namespace priv {
+
+    constexpr bool isSpace(const char c)
+    {
+      return c == ' '  ||  c == '\t'  ||  c == '\n'  ||
+          c == '\v'  ||  c == '\f'  ||  c == '\r';
+    }
+
+    // Trim whitespace & skip a leading '+'
+    bool prepare(const char*& first, const char*& last)
+    {
+      while( first != last  &&  isSpace(*first) ) {
+        ++first;
+      }
+      while( last != first  &&  isSpace(*(last - 1)) ) {
+        --last;
+      }
+
+      if( first != last  &&  *first == '+' ) {
+        ++first;
+        if( first != last  &&  (*first == '+'  ||  *first == '-') ) {
+          return false;
+        }
+      }
+
+      return first != last;
+    }
+
+    template<typename T>
+    bool toInteger(const char *first, const char *last, T& value)
+    {
+      if( !prepare(first, last) ) {
+        return false;
+      }
+
+      T result{};
+      const std::from_chars_result r = std::from_chars(first, last, result, 10);
+      if( r.ec != std::errc()  ||  r.ptr != last ) {
+        return false;
+      }
+
+      value = result;
+
+      return true;
+    }
+
+  } // namespace priv
+
+  ////// Public //////////////////////////////////////////////////////////////
+
+  bool toValue(const char *first, const char *last, int& value)
+  {
+    return priv::toInteger(first, last, value);
+  }
+
+  bool toValue(const char *first, const char *last, unsigned int& value)
+  {
+    return priv::toInteger(first, last, value);
+  }
+
+  bool toValue(const char *first, const char *last, unsigned long& value)
+  {
+    return priv::toInteger(first, last, value);
+  }
+
+  bool toValue(const char *first, const char *last, unsigned long long& value)
+  {
+    return priv::toInteger(first, last, value);
+  }
+
+  bool toValue(const char *first, const char *last, double& value)
+  {
+    if( !priv::prepare(first, last) ) {
+      return false;
+    }
+
+#if __cpp_lib_to_chars >= 201611L
+    double result{};
+    const std::from_chars_result r =
+        std::from_chars(first, last, result, std::chars_format::general);
+    if( r.ec != std::errc()  ||  r.ptr != last ) {
+      return false;
+    }
+#else
+    // NOTE: No floating point std::from_chars(); QByteArray uses the "C" locale.
+    bool ok{false};
+    const double result =
+        QByteArray::fromRawData(first, int(last - first)).toDouble(&ok);
+    if( !ok ) {
+      return false;
+    }
+#endif
+
+    value = result;
+
+    return true;
+  }
+
+  bool toValue(const char *first, const char *last, numhour_t& value)
+  {
+    double hours{};
+    return toValue(first, last, hours)  &&  numhour_t::fromDouble(value, hours);
+  }
+
+} // namespace Parse
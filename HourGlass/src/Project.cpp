@@ -29,6 +29,9 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <algorithm>
+#include <utility>
+
 #include "Project.h"
 
 ////// public ////////////////////////////////////////////////////////////////
@@ -50,3 +53,163 @@ projectid_t Project::id() const
 {
   return _id;
 }
+
+////// public - ProjectDB ////////////////////////////////////////////////////
+
+bool ProjectDB::add(Project p)
+{
+  if( !p  ||  contains(p.id()) ) {
+    return false;
+  }
+
+  const projectid_t id = p.id();
+
+  if( isDenseId(id) ) {
+    if( id >= _table.size() ) {
+      grow(std::max<size_type>(size_type(id) + 1, _table.size()*2));
+    }
+    _table[id] = std::move(p);
+  } else {
+    _sparse.emplace(id, std::move(p));
+  }
+
+  _count++;
+  _is_names_valid = false;
+
+  return true;
+}
+
+void ProjectDB::clear()
+{
+  *this = ProjectDB();
+}
+
+bool ProjectDB::contains(const projectid_t id) const
+{
+  return find(id) != nullptr;
+}
+
+bool ProjectDB::empty() const
+{
+  return _count == 0;
+}
+
+Project *ProjectDB::find(const projectid_t id)
+{
+  return const_cast<Project*>(std::as_const(*this).find(id));
+}
+
+const Project *ProjectDB::find(const projectid_t id) const
+{
+  if( id < _table.size() ) {
+    const Project& p = _table[id];
+    return p.id() != INVALID_PROJECTID
+        ? &p
+        : nullptr;
+  }
+
+  if( _sparse.empty() ) {
+    return nullptr;
+  }
+
+  const auto hit = _sparse.find(id);
+
+  return hit != _sparse.cend()
+      ? &hit->second
+      : nullptr;
+}
+
+ProjectIDs ProjectDB::ids() const
+{
+  ProjectIDs result;
+  result.reserve(_count);
+
+  for(const Project& p : _table) {
+    if( p.id() != INVALID_PROJECTID ) {
+      result.push_back(p.id());
+    }
+  }
+
+  // NOTE: Sparse IDs are beyond the table.
+  const std::size_t numDense = result.size();
+  for(const auto& v : _sparse) {
+    result.push_back(v.first);
+  }
+  std::sort(result.begin() + numDense, result.end());
+
+  return result;
+}
+
+projectid_t ProjectDB::maxId() const
+{
+  if( !_sparse.empty() ) {
+    const auto hit = std::max_element(_sparse.cbegin(), _sparse.cend(),
+                                      [](const auto& a, const auto& b) -> bool {
+      return a.first < b.first;
+    });
+    return hit->first;
+  }
+
+  for(auto it = _table.crbegin(); it != _table.crend(); ++it) {
+    if( it->id() != INVALID_PROJECTID ) {
+      return it->id();
+    }
+  }
+
+  return INVALID_PROJECTID;
+}
+
+ProjectDB::size_type ProjectDB::size() const
+{
+  return _count;
+}
+
+const ProjectIDs& ProjectDB::nameIndex() const
+{
+  if( _is_names_valid ) {
+    return _names;
+  }
+
+  _names = ids();
+  std::sort(_names.begin(), _names.end(), [this](const projectid_t a, const projectid_t b) -> bool {
+    const int cmp = find(a)->name.compare(find(b)->name, Qt::CaseInsensitive);
+    return cmp != 0
+        ? cmp < 0
+        : a < b;
+  });
+  _is_names_valid = true;
+
+  return _names;
+}
+
+void ProjectDB::invalidateNameIndex()
+{
+  _is_names_valid = false;
+}
+
+////// private - ProjectDB ///////////////////////////////////////////////////
+
+void ProjectDB::grow(const size_type size)
+{
+  _table.resize(size);
+
+  // Adopt sparse IDs now covered by the table
+  for(auto it = _sparse.begin(); it != _sparse.end(); ) {
+    if( it->first < size ) {
+      _table[it->first] = std::move(it->second);
+      it = _sparse.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+// NOTE: Holes may at most about double the table, cf. makeProject()'s
+//       sequential IDs.
+bool ProjectDB::isDenseId(const projectid_t id) const
+{
+  constexpr size_type MIN_TABLE = 64;
+
+  return id < _table.size()  ||
+      size_type(id) < std::max<size_type>(MIN_TABLE, 2*(_count + 1));
+}
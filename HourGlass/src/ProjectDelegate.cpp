@@ -55,7 +55,7 @@ QWidget *ProjectDelegate::createEditor(QWidget *parent,
   combo->setFrame(false);
   combo->setMaxVisibleItems(MAX_VISIBLE);
 
-  const ProjectIDs projects = global.listProjects();
+  const ProjectIDs& projects = global.listProjectsByName();
   for(const projectid_t id : projects) {
     const Project *p = global.findProject(id);
     if( p == nullptr ) {
@@ -50,8 +50,12 @@ void ProjectModel::addProject(const QString& name)
     return;
   }
 
+  const Project p = global.makeProject(name);
+
   beginResetModel();
-  global.add(global.makeProject(name));
+  if( global.add(p) ) {
+    journal.addProject(p);
+  }
   _projects = global.listProjects();
   endResetModel();
 
@@ -63,6 +67,15 @@ void ProjectModel::clearProjects()
   setProjects(ProjectDB());
 }
 
+void ProjectModel::resetProjects()
+{
+  beginResetModel();
+  _projects = global.listProjects();
+  endResetModel();
+
+  emit projectsChanged();
+}
+
 void ProjectModel::setProjects(ProjectDB projects)
 {
   beginResetModel();
@@ -167,11 +180,12 @@ bool ProjectModel::setData(const QModelIndex& index, const QVariant& value,
     if( !name.isEmpty() ) {
       p->name = name;
 
+      global.setProjectModified(p->id());
+      journal.setProjectName(p->id(), p->name);
+
       emit dataChanged(index, index);
       emit projectsChanged();
 
-      global.setModified();
-
       return true;
     }
 
@@ -182,7 +196,8 @@ bool ProjectModel::setData(const QModelIndex& index, const QVariant& value,
 
     emit dataChanged(index, index);
 
-    global.setModified();
+    global.setProjectModified(p->id());
+    journal.setProjectAnnotation(p->id(), p->annotation);
 
     return true;
 
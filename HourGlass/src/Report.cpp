@@ -0,0 +1,89 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+#include "Report.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  using ReportMap = std::unordered_map<projectid_t,numhour_t>;
+
+} // namespace priv
+
+////// Public ////////////////////////////////////////////////////////////////
+
+Report generateReport(const Month& month)
+{
+  if( !month ) {
+    return Report();
+  }
+
+  // (1) Sum each Item's hours ///////////////////////////////////////////////
+
+  priv::ReportMap map;
+  for(const Item& item : month.items) {
+    if( !map.contains(item.projectId) ) {
+      map[item.projectId] = numhour_t{0};
+    }
+
+    map[item.projectId] += item.sumHours();
+  } // Item
+
+  // (2) unordered_map<> to vector<> /////////////////////////////////////////
+
+  Report result;
+  result.reserve(map.size());
+  for(const auto& v : map) {
+    result.emplace_back(v.first, v.second);
+  }
+
+  // (3) Sort by Project's ID ////////////////////////////////////////////////
+
+  std::sort(result.begin(), result.end());
+
+  return result;
+}
+
+numhour_t sumReport(const Report& report)
+{
+  auto lambda_sum = [](const numhour_t& lhs, const ReportEntry& rhs) -> numhour_t
+  {
+    return lhs + rhs.second;
+  };
+
+  return std::accumulate(report.cbegin(), report.cend(),
+                         numhour_t{0}, lambda_sum);
+}
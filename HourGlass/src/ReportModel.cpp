@@ -29,8 +29,6 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
-#include <unordered_map>
-
 #include <QtGui/QBrush>
 
 #include "ReportModel.h"
@@ -38,57 +36,6 @@
 #include "Global.h"
 #include "View.h"
 
-////// Private ///////////////////////////////////////////////////////////////
-
-namespace priv {
-
-  using ReportMap = std::unordered_map<projectid_t,numhour_t>;
-
-  Report generateReport(const Month& month)
-  {
-    if( !month ) {
-      return Report();
-    }
-
-    // (1) Sum each Item's hours /////////////////////////////////////////////
-
-    ReportMap map;
-    for(const Item& item : month.items) {
-      if( !map.contains(item.projectId) ) {
-        map[item.projectId] = numhour_t{0};
-      }
-
-      map[item.projectId] += item.sumHours();
-    } // Item
-
-    // (2) unordered_map<> to vector<> ///////////////////////////////////////
-
-    Report result;
-    result.reserve(map.size());
-    for(const auto& v : map) {
-      result.emplace_back(v.first, v.second);
-    }
-
-    // (3) Sort by Project's ID //////////////////////////////////////////////
-
-    std::sort(result.begin(), result.end());
-
-    return result;
-  }
-
-  numhour_t sum(const Report& report)
-  {
-    auto lambda_sum = [](const numhour_t& lhs, const ReportEntry& rhs) -> numhour_t
-    {
-      return lhs + rhs.second;
-    };
-
-    return std::accumulate(report.cbegin(), report.cend(),
-                           numhour_t{0}, lambda_sum);
-  }
-
-} // namespace priv
-
 ////// public ////////////////////////////////////////////////////////////////
 
 ReportModel::ReportModel(QObject *parent)
@@ -107,7 +54,7 @@ void ReportModel::setMonth(const Month *month)
   }
 
   beginResetModel();
-  _report = priv::generateReport(*month);
+  _report = generateReport(*month);
   endResetModel();
 }
 
@@ -154,7 +101,7 @@ QVariant ReportModel::data(const QModelIndex& index,
         return tr("Sum");
 
       } else if( column == COL_Hours ) {
-        return priv::sum(_report);
+        return View::toString(sumReport(_report));
 
       } // column
 
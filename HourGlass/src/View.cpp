@@ -29,24 +29,42 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <QtCore/QCoreApplication>
 #include <QtCore/QLocale>
+#include <QtWidgets/QMessageBox>
 
 #include "View.h"
 
+#include "IoError.h"
+
 namespace View {
 
   ////// Public //////////////////////////////////////////////////////////////
 
-  double toDouble(const QString& hours)
+  void showError(QWidget *parent, const IoError& error)
+  {
+    QMessageBox::critical(parent, QCoreApplication::translate("View", "Error"),
+                          error.toString());
+  }
+
+  bool toHours(numhour_t& hours, const QString& text)
   {
-    return QLocale().toDouble(hours);
+    if( text.trimmed().isEmpty() ) {
+      hours = numhour_t{0};
+      return true;
+    }
+
+    bool ok{false};
+    const double value = QLocale().toDouble(text, &ok);
+
+    return ok  &&  numhour_t::fromDouble(hours, value);
   }
 
-  QString toString(const double hours, const bool no_zero)
+  QString toString(const numhour_t hours, const bool no_zero)
   {
-    return no_zero  &&  hours == 0
+    return no_zero  &&  hours == numhour_t{0}
         ? QString()
-        : QLocale().toString(hours, 'f', 2);
+        : QLocale().toString(hours.toDouble(), 'f', 2);
   }
 
 } // namespace View
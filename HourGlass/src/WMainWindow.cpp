@@ -29,18 +29,45 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <utility>
+
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
 #include <QtCore/QSettings>
+#include <QtCore/QTimer>
+#include <QtGui/QCloseEvent>
 #include <QtWidgets/QFileDialog>
+#include <QtWidgets/QInputDialog>
 #include <QtWidgets/QMessageBox>
+#include <QtWidgets/QStatusBar>
 
 #include "WMainWindow.h"
 #include "ui_WMainWindow.h"
 
+#include "AutoSave.h"
+#include "Backup_io.h"
 #include "File_io.h"
 #include "Global.h"
+#include "HoursWriter.h"
+#include "IoError.h"
 #include "MonthModel.h"
 #include "ProjectModel.h"
 #include "RecentFiles.h"
+#include "View.h"
+
+////// Macros ////////////////////////////////////////////////////////////////
+
+#define SETTINGS_GROUP  QStringLiteral("WMainWindow")
+#define SETTINGS_VALUE  QStringLiteral("%1/%2")
+
+#define SETTING_AUTOSAVE        QStringLiteral("autosave")
+#define SETTING_AUTOSAVE_DELAY  QStringLiteral("autosave_delay")
+#define SETTING_JOURNAL         QStringLiteral("journal")
+#define SETTING_LAZY_LOADING    QStringLiteral("lazy_loading")
+
+#define JOURNAL_COMPACT_INTERVAL  60000 // [ms]
+
+#define STATUS_TIMEOUT  5000 // [ms]
 
 ////// public ////////////////////////////////////////////////////////////////
 
@@ -55,6 +82,24 @@ WMainWindow::WMainWindow(QWidget *parent, Qt::WindowFlags flags)
   _recent = new RecentFiles(this);
   ui->recentFilesAction->setMenu(_recent->menu());
 
+  // Autosave ////////////////////////////////////////////////////////////////
+
+  _autoSave = new AutoSave(this);
+  global.setModifiedHandler([autoSave = _autoSave]() -> void {
+    autoSave->notify();
+  });
+
+  // Background Writer & Journal ////////////////////////////////////////////
+
+  _writer = new HoursWriter(this);
+
+  _compactTimer = new QTimer(this);
+  _compactTimer->setInterval(JOURNAL_COMPACT_INTERVAL);
+
+  journal.setFailureHandler([this](const QString& errorString) -> void {
+    statusBar()->showMessage(tr("Journaling stopped! (%1)").arg(errorString));
+  });
+
   // Actions /////////////////////////////////////////////////////////////////
 
   ui->openAction->setShortcut(Qt::CTRL + Qt::Key_O);
@@ -73,6 +118,9 @@ WMainWindow::WMainWindow(QWidget *parent, Qt::WindowFlags flags)
   connect(ui->openAction, &QAction::triggered,
           this, &WMainWindow::open);
 
+  connect(ui->restoreBackupAction, &QAction::triggered,
+          this, &WMainWindow::openBackup);
+
   connect(ui->saveAction, &QAction::triggered,
           this, &WMainWindow::save);
   connect(ui->saveAsAction, &QAction::triggered,
@@ -92,103 +140,281 @@ WMainWindow::WMainWindow(QWidget *parent, Qt::WindowFlags flags)
 
   connect(ui->showProjectRowAction, &QAction::triggered,
           ui->hoursWidget->model(), &MonthModel::setShowProjectRow);
+
+  connect(ui->autoSaveAction, &QAction::toggled,
+          _autoSave, &AutoSave::setEnabled);
+
+  connect(ui->journalAction, &QAction::toggled,
+          this, &WMainWindow::setJournaling);
+  connect(_compactTimer, &QTimer::timeout,
+          this, &WMainWindow::compactJournal);
+  connect(_writer, &HoursWriter::finished,
+          this, &WMainWindow::writeFinished);
+
+  _autoSave->setEnabled(ui->autoSaveAction->isChecked());
+  setJournaling(ui->journalAction->isChecked());
 }
 
 WMainWindow::~WMainWindow()
 {
   saveSettings();
 
+  global.setModifiedHandler(nullptr);
+  journal.setFailureHandler(nullptr);
+  journal.close();
+
   delete ui;
 }
 
-////// private slots /////////////////////////////////////////////////////////
-
-void WMainWindow::open()
+void WMainWindow::recover()
 {
-  const QString filename = getFilename();
-  if( filename.isEmpty() ) {
+  if( !_autoSave->hasRecovery() ) {
     return;
   }
 
-  openFile(filename);
-}
+  // (1) Ask User ////////////////////////////////////////////////////////////
 
-void WMainWindow::openFile(const QString& filename)
-{
-  if( filename.isEmpty() ) {
+  const QString source = _autoSave->recoverySource();
+
+  const QMessageBox::StandardButton button =
+      QMessageBox::question(this, tr("Recovery"),
+                            tr("Recover unsaved changes of \"%1\"?")
+                            .arg(!source.isEmpty()
+                                 ? QFileInfo(source).fileName()
+                                 : tr("Untitled")));
+  if( button != QMessageBox::Yes ) {
+    _autoSave->removeRecovery();
     return;
   }
 
-  // (1) Read Hours file /////////////////////////////////////////////////////
+  // (2) Read Recovery file //////////////////////////////////////////////////
 
   Context context;
-  if( !readHoursFile(context, filename, this) ) {
+  IoError error;
+  if( !readHoursFile(context, _autoSave->recoveryFilename(), &error) ) {
+    View::showError(this, error);
     return;
   }
 
-  // (2) Update UI ///////////////////////////////////////////////////////////
-
-  ui->hoursWidget->clear();
-  ui->projectsWidget->clear();
-
-  // TODO
-  ui->projectsWidget->initializeUi(std::move(context._projects));
-  ui->hoursWidget->initializeUi(std::move(context._months));
+  resetContext(std::move(context));
 
   // (3) Update State ////////////////////////////////////////////////////////
 
-  _lastfilename = filename;
-  _recent->add(filename);
-  global.clearModified();
+  _lastfilename = source;
+  _autoSave->setSource(source);
+  openJournal(source);
+  global.setModified();
 }
 
-void WMainWindow::quit()
+////// protected /////////////////////////////////////////////////////////////
+
+void WMainWindow::closeEvent(QCloseEvent *event)
 {
   if( global.isModified() ) {
     const QMessageBox::StandardButton button =
         QMessageBox::question(this, tr("Quit"), tr("Save changes?"));
     if( button == QMessageBox::Yes ) {
       save();
+    } else {
+      journal.clear();
+      _autoSave->removeRecovery();
     }
   }
 
-  close();
+  _writer->wait();
+
+  event->accept();
 }
 
-void WMainWindow::save()
+////// private slots /////////////////////////////////////////////////////////
+
+void WMainWindow::compactJournal()
 {
-  // (1) Get filename ////////////////////////////////////////////////////////
+  if( !journal.isOpen()  ||  journal.isEmpty()  ||  _writer->isRunning() ) {
+    return;
+  }
+
+  startWrite(_lastfilename, false);
+}
 
-  const QString filename = _lastfilename.isEmpty()
-      ? getFilename(true)
-      : std::move(_lastfilename); // not empty
+void WMainWindow::open()
+{
+  const QString filename = getFilename();
   if( filename.isEmpty() ) {
     return;
   }
 
-  // (2) Backup Hours file ///////////////////////////////////////////////////
+  openFile(filename);
+}
+
+void WMainWindow::openBackup()
+{
+  if( _lastfilename.isEmpty() ) {
+    return;
+  }
+
+  // (1) Select backup ///////////////////////////////////////////////////////
 
-  backupHoursFile(filename);
+  _writer->wait();
+
+  const BackupTimes times = listBackups(_lastfilename);
+  if( times.isEmpty() ) {
+    QMessageBox::information(this, tr("Restore backup"), tr("No backups available!"));
+    return;
+  }
+
+  QStringList items;
+  for(const QDateTime& time : times) {
+    items.push_back(time.toString(QStringLiteral("yyyy-MM-dd HH:mm:ss")));
+  }
+
+  bool ok{false};
+  const QString item = QInputDialog::getItem(this, tr("Restore backup"), tr("Backup:"),
+                                             items, 0, false, &ok);
+  if( !ok  ||  !items.contains(item) ) {
+    return;
+  }
+
+  const QDateTime time = times[items.indexOf(item)];
+
+  // (2) Restore backup next to the Hours file ///////////////////////////////
+
+  const QFileInfo info(_lastfilename);
+  const QString target = info.dir().absoluteFilePath(QStringLiteral("%1-%2.%3")
+                                                     .arg(info.completeBaseName(),
+                                                          time.toString(QStringLiteral("yyyyMMdd-HHmmss")),
+                                                          info.suffix()));
+  if( !restoreBackup(_lastfilename, time, target) ) {
+    QMessageBox::critical(this, tr("Error"),
+                          tr("Unable to restore backup \"%1\"!").arg(item));
+    return;
+  }
+
+  openFile(target);
+}
+
+void WMainWindow::openFile(const QString& filename)
+{
+  if( filename.isEmpty() ) {
+    return;
+  }
 
-  // (3) Write Hours file ////////////////////////////////////////////////////
+  // (1) Read Hours file /////////////////////////////////////////////////////
 
-  if( !writeHoursFile(filename, global, this) ) {
+  Context context;
+  IoError error;
+  if( !readHoursFile(context, filename, &error, ui->lazyLoadingAction->isChecked()) ) {
+    View::showError(this, error);
     return;
   }
 
+  // (2) Replay Journal //////////////////////////////////////////////////////
+
+  const std::size_t numReplayed = ui->journalAction->isChecked()
+      ? Journal::replay(context, filename)
+      : 0;
+
+  // (3) Update UI ///////////////////////////////////////////////////////////
+
+  resetContext(std::move(context));
+
   // (4) Update State ////////////////////////////////////////////////////////
 
   _lastfilename = filename;
   _recent->add(filename);
   global.clearModified();
+
+  _autoSave->removeRecovery();
+  _autoSave->setSource(filename);
+
+  openJournal(filename);
+  if( numReplayed > 0 ) {
+    global.setModified();
+    compactJournal();
+  }
+}
+
+void WMainWindow::quit()
+{
+  // NOTE: Handled by closeEvent(), just like closing the window.
+  close();
+}
+
+void WMainWindow::save()
+{
+  saveFile(_lastfilename.isEmpty()
+           ? getFilename(true)
+           : _lastfilename);
 }
 
 void WMainWindow::saveAs()
 {
-  const QString filename = getFilename(true);
-  if( !filename.isEmpty() ) {
+  saveFile(getFilename(true));
+}
+
+void WMainWindow::setJournaling(const bool on)
+{
+  if( on ) {
+    openJournal(_lastfilename);
+    _compactTimer->start();
+  } else {
+    _compactTimer->stop();
+    journal.close();
+  }
+}
+
+void WMainWindow::writeFinished(const QString& filename, const bool ok)
+{
+  const bool         is_save = std::exchange(_is_saving, false);
+  const qint64   journalSize = std::exchange(_writeJournalSize, 0);
+  const QString     fileInfo = QFileInfo(filename).fileName();
+
+  if( !ok ) {
+    if( is_save ) {
+      statusBar()->clearMessage();
+      View::showError(this, _writer->error());
+    }
+    return;
+  }
+
+  // (1) Fold Journal ////////////////////////////////////////////////////////
+
+  journal.discard(journalSize);
+
+  // (2) Switch to Saved File ////////////////////////////////////////////////
+
+  if( filename != _lastfilename ) {
+    // NOTE: The remaining records were made during the write.
+    if( journal.isOpen() ) {
+      journal.moveTo(filename);
+    } else {
+      openJournal(filename);
+      journal.clear();
+    }
+
     _lastfilename = filename;
-    save();
+    _autoSave->setSource(filename);
+  }
+
+  // (3) Update State ////////////////////////////////////////////////////////
+
+  // NOTE: Edits made during the write keep the context modified.
+  const Context& snapshot = _writer->snapshot();
+  if( global.revision() == snapshot.revision() ) {
+    global.cacheFragments(_writer->takeFragments());
+    global.clearModified();
+    _autoSave->removeRecovery();
+  }
+
+  if( is_save ) {
+    _recent->add(filename);
+    statusBar()->showMessage(tr("Saved \"%1\".").arg(fileInfo), STATUS_TIMEOUT);
+  }
+
+  // (4) Handle Pending Save /////////////////////////////////////////////////
+
+  if( std::exchange(_is_save_pending, false) ) {
+    startWrite(_lastfilename, true);
   }
 }
 
@@ -204,13 +430,75 @@ QString WMainWindow::getFilename(const bool is_save)
 
   const QString filename = is_save
       ? QFileDialog::getSaveFileName(this, tr("Save as"),
-                                     dir, tr("HourGlass files (*.xhours)"))
+                                     dir, tr("HourGlass files (*.xhours);;"
+                                             "HourGlass compressed files (*.xhours.z);;"
+                                             "HourGlass binary files (*.hgbin)"))
       : QFileDialog::getOpenFileName(this, tr("Open"),
-                                     dir, tr("HourGlass files (*.xhours)"));
+                                     dir, tr("HourGlass files (*.xhours *.xhours.z *.hgbin)"));
 
   return filename;
 }
 
+void WMainWindow::resetContext(Context context)
+{
+  _writer->wait();
+
+  ui->hoursWidget->clear();
+  ui->projectsWidget->clear();
+
+  global = std::move(context);
+
+  ui->projectsWidget->initializeUi();
+  ui->hoursWidget->initializeUi();
+}
+
+void WMainWindow::saveFile(const QString& filename)
+{
+  if( filename.isEmpty() ) {
+    return;
+  }
+
+  // (1) Defer resp. finish running write ////////////////////////////////////
+
+  if( _writer->isRunning()  &&  filename == _lastfilename ) {
+    _is_save_pending = true;
+    return;
+  }
+
+  _writer->wait();
+
+  // (2) Write Hours file in the background //////////////////////////////////
+
+  // NOTE: The journal & filename are switched once "filename" is written;
+  //       cf. writeFinished().
+  startWrite(filename, true);
+}
+
+void WMainWindow::startWrite(const QString& filename, const bool is_save)
+{
+  _is_saving = is_save;
+  _writeJournalSize = journal.size();
+
+  if( !_writer->start(filename, global, is_save) ) {
+    _is_saving = false;
+    _writeJournalSize = 0;
+    return;
+  }
+
+  if( is_save ) {
+    statusBar()->showMessage(tr("Saving \"%1\"...")
+                             .arg(QFileInfo(filename).fileName()));
+  }
+}
+
+void WMainWindow::openJournal(const QString& filename)
+{
+  journal.close();
+  if( ui->journalAction->isChecked()  &&  !filename.isEmpty() ) {
+    journal.open(filename);
+  }
+}
+
 void WMainWindow::loadSettings()
 {
   QSettings settings(QSettings::IniFormat, QSettings::UserScope,
@@ -219,6 +507,15 @@ void WMainWindow::loadSettings()
 
   ui->hoursWidget->load(settings);
   _recent->load(settings);
+
+  ui->autoSaveAction->setChecked(settings.value(SETTINGS_VALUE.arg(SETTINGS_GROUP, SETTING_AUTOSAVE),
+                                                false).toBool());
+  _autoSave->setDelay(settings.value(SETTINGS_VALUE.arg(SETTINGS_GROUP, SETTING_AUTOSAVE_DELAY),
+                                     _autoSave->delay()).toInt());
+  ui->journalAction->setChecked(settings.value(SETTINGS_VALUE.arg(SETTINGS_GROUP, SETTING_JOURNAL),
+                                               false).toBool());
+  ui->lazyLoadingAction->setChecked(settings.value(SETTINGS_VALUE.arg(SETTINGS_GROUP, SETTING_LAZY_LOADING),
+                                                   false).toBool());
 }
 
 void WMainWindow::saveSettings()
@@ -231,5 +528,15 @@ void WMainWindow::saveSettings()
   ui->hoursWidget->save(settings);
   _recent->save(settings);
 
+  settings.remove(SETTINGS_GROUP);
+  settings.setValue(SETTINGS_VALUE.arg(SETTINGS_GROUP, SETTING_AUTOSAVE),
+                    ui->autoSaveAction->isChecked());
+  settings.setValue(SETTINGS_VALUE.arg(SETTINGS_GROUP, SETTING_AUTOSAVE_DELAY),
+                    _autoSave->delay());
+  settings.setValue(SETTINGS_VALUE.arg(SETTINGS_GROUP, SETTING_JOURNAL),
+                    ui->journalAction->isChecked());
+  settings.setValue(SETTINGS_VALUE.arg(SETTINGS_GROUP, SETTING_LAZY_LOADING),
+                    ui->lazyLoadingAction->isChecked());
+
   settings.sync();
 }
@@ -68,9 +68,9 @@ void WProjects::clear()
   _model->clearProjects();
 }
 
-void WProjects::initializeUi(ProjectDB projects)
+void WProjects::initializeUi()
 {
-  _model->setProjects(std::move(projects));
+  _model->resetProjects();
 }
 
 ProjectModel *WProjects::model() const
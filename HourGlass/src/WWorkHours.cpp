@@ -36,8 +36,10 @@
 #include "ui_WWorkHours.h"
 
 #include "Global.h"
+#include "IoError.h"
 #include "MonthModel.h"
 #include "ProjectDelegate.h"
+#include "View.h"
 #include "WReport.h"
 
 ////// Macros ////////////////////////////////////////////////////////////////
@@ -101,9 +103,8 @@ void WWorkHours::clear()
   _model->clearMonth();
 }
 
-void WWorkHours::initializeUi(MonthDB months)
+void WWorkHours::initializeUi()
 {
-  global.set(std::move(months));
   initMonthsCombo();
 }
 
@@ -152,7 +153,7 @@ void WWorkHours::updateProjects()
   // Projects Combo //////////////////////////////////////////////////////////
 
   ui->projectCombo->clear();
-  const ProjectIDs projects = global.listProjects();
+  const ProjectIDs& projects = global.listProjectsByName();
   for(const projectid_t id : projects) {
     const Project *p = global.findProject(id);
     if( p == nullptr ) {
@@ -178,9 +179,11 @@ void WWorkHours::addItem()
 void WWorkHours::addMonth()
 {
   Month m = Month(ui->dateEdit->date());
+  const monthid_t id = m.id();
   if( !global.add(std::move(m)) ) {
     return;
   }
+  journal.addMonth(id);
   initMonthsCombo();
 }
 
@@ -219,7 +222,14 @@ void WWorkHours::setMonth(int index)
   resetColumns();
 
   const monthid_t id = ui->monthCombo->itemData(index).toInt();
-  _model->setMonth(global.findMonth(id));
+
+  IoError error;
+  Month *month = global.findMonth(id, &error);
+  if( month == nullptr  &&  error.isError() ) {
+    View::showError(this, error);
+  }
+
+  _model->setMonth(month);
 }
 
 void WWorkHours::showWeek()
@@ -280,11 +290,10 @@ void WWorkHours::initMonthsCombo()
   ui->monthCombo->clear();
   const MonthIDs months = global.listMonths();
   for(const monthid_t id : months) {
-    const Month *m = global.findMonth(id);
-    if( m == nullptr ) {
-      continue;
-    }
+    // NOTE: Do not load the month; it is loaded upon selection.
+    const SplitId sid = split_monthid(id);
+    const Month m(sid.first, sid.second);
 
-    ui->monthCombo->addItem(m->toString(), m->id());
+    ui->monthCombo->addItem(m.toString(), m.id());
   }
 }
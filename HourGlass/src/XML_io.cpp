@@ -29,13 +29,25 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include <QtCore/QBuffer>
 #include <QtCore/QCoreApplication>
-#include <QtWidgets/QMessageBox>
-#include <QtXml/QDomDocument>
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QXmlStreamReader>
+#include <QtCore/QXmlStreamWriter>
 
 #include "XML_io.h"
 
 #include "Context.h"
+#include "Format.h"
+#include "IoError.h"
+#include "Parse.h"
 #include "XML_tags.h"
 
 ////// Macros ////////////////////////////////////////////////////////////////
@@ -44,47 +56,30 @@
 
 ////// Private ///////////////////////////////////////////////////////////////
 
-inline QString toQString(const numhour_t hour)
-{
-  return QString::number(hour, 'f', 2);
-}
-
-template<typename T, typename REF>
-using if_same_t = std::enable_if_t<std::is_same_v<T,REF>,T>;
-
-template<typename T>
-inline if_same_t<T,int> toValue(const QString& s,
-                                bool *ok = nullptr, int base = 10)
-{
-  return s.toInt(ok, base);
-}
-
-template<typename T>
-inline if_same_t<T,unsigned int> toValue(const QString& s,
-                                         bool *ok = nullptr, int base = 10)
-{
-  return s.toUInt(ok, base);
-}
-
-template<typename T>
-inline if_same_t<T,unsigned long long> toValue(const QString& s,
-                                               bool *ok = nullptr, int base = 10)
+/*
+ * NOTE: QXmlStreamReader transcodes a QByteArray to UTF-16 in a single pass,
+ *       but reads a QIODevice in chunks of 8 KiB. Hence, in-memory content is
+ *       always read through a QBuffer, which shares the (mapped) bytes.
+ */
+inline bool xmlOpenBuffer(QBuffer& buffer, const QByteArray& content)
 {
-  return s.toULongLong(ok, base);
+  buffer.setData(content);
+  return buffer.open(QIODevice::ReadOnly);
 }
 
 template<typename T>
-inline if_same_t<T,double> toValue(const QString& s,
-                                   bool *ok = nullptr, int = 0)
+inline T toValue(const QStringRef& s, bool *ok)
 {
-  return s.toDouble(ok);
+  T value{};
+  *ok = Parse::toValue(s.constData(), s.constData() + s.size(), value);
+  return value;
 }
 
 template<typename T>
-inline T xmlAttributeValue(const QDomElement& elem, const QString& name,
+inline T xmlAttributeValue(const QXmlStreamReader& xml, const QString& name,
                            const T& errValue = T())
 {
-  const QString strValue = elem.attribute(name, QString());
+  const QStringRef strValue = xml.attributes().value(name);
   if( strValue.isEmpty() ) {
     return errValue;
   }
@@ -98,162 +93,645 @@ inline T xmlAttributeValue(const QDomElement& elem, const QString& name,
   return value;
 }
 
-inline bool xmlIsTag(const QDomElement& elem, const QString& name)
+template<typename T>
+inline bool xmlElementValue(QXmlStreamReader& xml, T& value)
 {
-  return !elem.isNull()  &&  elem.tagName() == name;
+  // NOTE: The value is parsed from the reader's buffer in place; the
+  //       referenced text is only valid until the next token is read.
+  bool have_value{false};
+  while( !xml.atEnd() ) {
+    const QXmlStreamReader::TokenType token = xml.readNext();
+
+    if(        token == QXmlStreamReader::Characters ) {
+      if( xml.isWhitespace()  &&  have_value ) {
+        continue;
+      }
+
+      if( have_value ) {
+        return false;
+      }
+
+      bool ok{false};
+      value = toValue<T>(xml.text(), &ok);
+      if( !ok ) {
+        return false;
+      }
+
+      have_value = true;
+
+    } else if( token == QXmlStreamReader::EndElement ) {
+      return have_value;
+
+    } else if( token == QXmlStreamReader::StartElement ) {
+      return false;
+
+    } // token
+  }
+
+  return false;
+}
+
+inline bool xmlError(QXmlStreamReader& xml, const QString& message)
+{
+  xml.raiseError(message);
+  return false;
 }
 
 ////// Private - Read Months /////////////////////////////////////////////////
 
-bool xmlReadHours(Hours& hours, const QDomElement& xml_item)
+bool xmlReadHours(Hours& hours, QXmlStreamReader& xml)
 {
-  const QDomElement xml_hours = xml_item.firstChildElement(XML_hours);
-  if( xml_hours.isNull() ) {
-    return true; // Optional
-  }
+  while( xml.readNextStartElement() ) {
+    if( xml.name() != XML_day ) {
+      xml.skipCurrentElement();
+      continue;
+    }
 
-  for(QDomElement xml_day = xml_hours.firstChildElement(XML_day);
-      !xml_day.isNull();
-      xml_day = xml_day.nextSiblingElement(XML_day)) {
-    const std::size_t did = xmlAttributeValue(xml_day, XML_did, hours.size());
+    const std::size_t did = xmlAttributeValue<std::size_t>(xml, XML_did, hours.size());
     if( did >= hours.size() ) {
+      return xmlError(xml, QCoreApplication::translate(TR_CTX, "Invalid day!"));
+    }
+
+    numhour_t value;
+    if( !xmlElementValue(xml, value) ) {
+      if( xml.hasError() ) {
+        return false;
+      }
+      return xmlError(xml, QCoreApplication::translate(TR_CTX, "Invalid hours!"));
+    }
+
+    hours.set(did, value);
+  }
+
+  return !xml.hasError();
+}
+
+bool xmlReadItem(Item& item, QXmlStreamReader& xml)
+{
+  item.projectId = xmlAttributeValue<projectid_t>(xml, XML_pid, INVALID_PROJECTID);
+  if( item.projectId == INVALID_PROJECTID ) {
+    return xmlError(xml, QCoreApplication::translate(TR_CTX, "Invalid project ID!"));
+  }
+
+  while( xml.readNextStartElement() ) {
+    if(        xml.name() == XML_activity ) {
+      item.activity = xml.readElementText(QXmlStreamReader::IncludeChildElements);
+    } else if( xml.name() == XML_hours ) {
+      if( !xmlReadHours(item.hours, xml) ) {
+        return false;
+      }
+    } else {
+      xml.skipCurrentElement();
+    }
+  }
+
+  return !xml.hasError();
+}
+
+bool xmlReadItems(Items& items, QXmlStreamReader& xml)
+{
+  while( xml.readNextStartElement() ) {
+    if( xml.name() != XML_item ) {
+      xml.skipCurrentElement();
+      continue; // successfully ignored
+    }
+
+    Item item;
+    if( !xmlReadItem(item, xml) ) {
       return false;
     }
 
-    bool ok{false};
-    hours[did] = toValue<numhour_t>(xml_day.text(), &ok);
-    if( !ok ) {
+    items.push_back(std::move(item));
+  }
+
+  return !xml.hasError();
+}
+
+bool xmlReadMonth(Month& month, QXmlStreamReader& xml)
+{
+  const monthid_t mid =
+      xmlAttributeValue<monthid_t>(xml, XML_mid, INVALID_MONTHID);
+  if( mid == INVALID_MONTHID ) {
+    return xmlError(xml, QCoreApplication::translate(TR_CTX, "Invalid month ID!"));
+  }
+
+  const SplitId sid = split_monthid(mid);
+
+  month = Month(sid.first, sid.second);
+  if( !month ) {
+    return xmlError(xml, QCoreApplication::translate(TR_CTX, "Invalid month %1!")
+                    .arg(mid));
+  }
+
+  while( xml.readNextStartElement() ) {
+    if( xml.name() != XML_items ) {
+      xml.skipCurrentElement();
+      continue; // Optional
+    }
+
+    if( !xmlReadItems(month.items, xml) ) {
       return false;
     }
   }
 
+  return !xml.hasError();
+}
+
+bool xmlReadMonth(Context& context, QXmlStreamReader& xml)
+{
+  Month month;
+  if( !xmlReadMonth(month, xml) ) {
+    return false;
+  }
+
+  const monthid_t mid = month.id();
+
+  if( !context.add(std::move(month)) ) {
+    return xmlError(xml, QCoreApplication::translate(TR_CTX, "Invalid month %1!")
+                    .arg(mid));
+  }
+
   return true;
 }
 
-bool xmlReadItem(Item& item, const QDomElement xml_item)
+bool xmlReadMonths(Context& context, QXmlStreamReader& xml)
 {
-  if( !xmlIsTag(xml_item, XML_item) ) {
-    return true; // successfully ignored
+  while( xml.readNextStartElement() ) {
+    if( xml.name() != XML_month ) {
+      xml.skipCurrentElement();
+      continue; // successfully ignored
+    }
+
+    if( !xmlReadMonth(context, xml) ) {
+      return false;
+    }
   }
 
-  item.projectId = xmlAttributeValue<projectid_t>(xml_item, XML_pid, INVALID_PROJECTID);
-  if( item.projectId == INVALID_PROJECTID ) {
+  return !xml.hasError();
+}
+
+////// Private - Read Projects ///////////////////////////////////////////////
+
+bool xmlReadProject(Context& context, QXmlStreamReader& xml)
+{
+  const projectid_t id =
+      xmlAttributeValue<projectid_t>(xml, XML_pid, INVALID_PROJECTID);
+  if( id == INVALID_PROJECTID ) {
+    return xmlError(xml, QCoreApplication::translate(TR_CTX, "Invalid project ID!"));
+  }
+
+  bool have_name{false};
+  QString name;
+  QString annotation;
+  while( xml.readNextStartElement() ) {
+    if(        xml.name() == XML_name ) {
+      name = xml.readElementText(QXmlStreamReader::IncludeChildElements).trimmed();
+      have_name = true;
+    } else if( xml.name() == XML_annotation ) {
+      annotation = xml.readElementText(QXmlStreamReader::IncludeChildElements).trimmed();
+    } else {
+      xml.skipCurrentElement();
+    }
+  }
+
+  if( xml.hasError() ) {
     return false;
   }
 
-  const QDomElement xml_activity = xml_item.firstChildElement(XML_activity);
-  item.activity = xml_activity.text();
+  if( !have_name ) {
+    return xmlError(xml, QCoreApplication::translate(TR_CTX, "Missing name of project %1!")
+                    .arg(id));
+  }
 
-  return xmlReadHours(item.hours, xml_item);
+  if( !context.add({id, name, annotation}) ) {
+    return xmlError(xml, QCoreApplication::translate(TR_CTX, "Invalid project %1!")
+                    .arg(id));
+  }
+
+  return true;
 }
 
-bool xmlReadItems(Items& items, const QDomElement& xml_month)
+bool xmlReadProjects(Context& context, QXmlStreamReader& xml)
 {
-  const QDomElement xml_items = xml_month.firstChildElement(XML_items);
-  if( xml_items.isNull() ) {
-    return true; // Optional
-  }
+  while( xml.readNextStartElement() ) {
+    if( xml.name() != XML_project ) {
+      xml.skipCurrentElement();
+      continue; // successfully ignored
+    }
 
-  for(QDomElement xml_item = xml_items.firstChildElement();
-      !xml_item.isNull();
-      xml_item = xml_item.nextSiblingElement()) {
-    Item item;
-    if( !xmlReadItem(item, xml_item) ) {
+    if( !xmlReadProject(context, xml) ) {
       return false;
     }
+  }
+
+  return !xml.hasError();
+}
+
+////// Private - Read Document ///////////////////////////////////////////////
+
+bool xmlReadHourGlass(Context& context, QXmlStreamReader& xml)
+{
+  if( !xml.readNextStartElement() ) {
+    return false;
+  }
+
+  if( xml.name() != XML_HourGlass ) {
+    return xmlError(xml, QCoreApplication::translate(TR_CTX, "Invalid root element!"));
+  }
+
+  while( xml.readNextStartElement() ) {
+    if(        xml.name() == XML_projects ) {
+      if( !xmlReadProjects(context, xml) ) {
+        return false;
+      }
+    } else if( xml.name() == XML_months ) {
+      if( !xmlReadMonths(context, xml) ) {
+        return false;
+      }
+    } else {
+      xml.skipCurrentElement(); // Optional
+    }
+  }
 
-    items.push_back(std::move(item));
+  // Check well-formedness of the remaining document...
+  while( !xml.atEnd() ) {
+    xml.readNext();
+  }
+
+  return !xml.hasError();
+}
+
+bool xmlRead(Context& context, QXmlStreamReader& xml, IoError *error)
+{
+  context.clear();
+
+  if( !xmlReadHourGlass(context, xml) ) {
+    return xml.hasError()
+        ? setIoError(error, IoError::ReadError, xml.errorString(),
+                     xml.lineNumber(), xml.columnNumber())
+        : setIoError(error, IoError::ReadError,
+                     QCoreApplication::translate(TR_CTX, "Invalid XML document!"));
   }
 
   return true;
 }
 
-bool xmlReadMonth(Context& context, const QDomElement& xml_month)
+////// Private - Parallel Read ///////////////////////////////////////////////
+
+/*
+ * NOTE: The parallel reader locates the <month> elements with a plain byte
+ *       scan of the UTF-8 input. This is only valid if every '<' starts a
+ *       tag, i.e. if there are no comments, CDATA sections or DTDs; any
+ *       other input is handed to the sequential reader.
+ */
+
+constexpr std::size_t PARALLEL_MIN_MONTHS = 24;
+
+struct XmlMonthFragment {
+  int     begin{0};
+  int     end{0};
+  qint64  line{1};
+  Month   month;
+  QString error;
+  qint64  errorLine{0};
+  qint64  errorColumn{0};
+};
+
+using XmlMonthFragments = std::vector<XmlMonthFragment>;
+
+inline bool xmlIsSpace(const char c)
+{
+  return c == ' '  ||  c == '\t'  ||  c == '\n'  ||  c == '\r';
+}
+
+inline qint64 xmlCountLines(const QByteArray& content, const int from, const int to)
 {
-  if( !xmlIsTag(xml_month, XML_month) ) {
-    return true; // successfully ignored
+  return std::count(content.constData() + from, content.constData() + to, '\n');
+}
+
+bool xmlIsTagAt(const QByteArray& content, const int pos, const char *tag)
+{
+  const int len = int(std::strlen(tag));
+  if( pos < 0  ||  pos + len >= content.size() ) {
+    return false;
   }
 
-  const monthid_t mid =
-      xmlAttributeValue<monthid_t>(xml_month, XML_mid, INVALID_MONTHID);
-  if( mid == INVALID_MONTHID ) {
+  if( std::strncmp(content.constData() + pos, tag, std::size_t(len)) != 0 ) {
     return false;
   }
 
-  const SplitId sid = split_monthid(mid);
+  const char next = content[pos + len];
 
-  if( !context.add(Month(sid.first, sid.second)) ) {
-    return false;
+  return xmlIsSpace(next)  ||  next == '>'  ||  next == '/';
+}
+
+int xmlFindTag(const QByteArray& content, const char *tag, int from)
+{
+  for(int pos = content.indexOf(tag, from); pos >= 0; pos = content.indexOf(tag, pos + 1)) {
+    if( xmlIsTagAt(content, pos, tag) ) {
+      return pos;
+    }
+  }
+
+  return -1;
+}
+
+bool xmlIsPlainUtf8(const QByteArray& content)
+{
+  if( content.startsWith("\xFE\xFF")  ||  content.startsWith("\xFF\xFE") ) {
+    return false; // UTF-16
   }
 
-  Month *month = context.findMonth(mid);
+  const int declBegin = content.indexOf("<?xml");
+  if( declBegin >= 0  &&  declBegin <= 3 ) {
+    const int declEnd = content.indexOf("?>", declBegin);
+    if( declEnd < 0 ) {
+      return false;
+    }
 
-  return month != nullptr
-      ? xmlReadItems(month->items, xml_month)
-      : false;
+    const QByteArray decl = content.mid(declBegin, declEnd - declBegin).toLower();
+    if( decl.contains("encoding")  &&  !decl.contains("utf-8") ) {
+      return false;
+    }
+  }
+
+  return !content.contains("<!");
 }
 
-bool xmlReadMonths(Context& context, const QDomElement& xml_root)
+bool xmlScanMonths(XmlMonthFragments& fragments, const QByteArray& content)
 {
-  const QDomElement xml_months = xml_root.firstChildElement(XML_months);
-  if( xml_months.isNull() ) {
-    return true; // Optional
+  fragments.clear();
+
+  if( !xmlIsPlainUtf8(content) ) {
+    return false;
+  }
+
+  // (1) Locate <months> /////////////////////////////////////////////////////
+
+  const int months = xmlFindTag(content, "<months", 0);
+  if( months < 0  ||  xmlFindTag(content, "<months", months + 1) >= 0 ) {
+    return false;
   }
 
-  for(QDomElement xml_month = xml_months.firstChildElement();
-      !xml_month.isNull();
-      xml_month = xml_month.nextSiblingElement()) {
-    if( !xmlReadMonth(context, xml_month) ) {
+  int pos = content.indexOf('>', months);
+  if( pos < 0  ||  content[pos - 1] == '/' ) {
+    return false;
+  }
+  pos++;
+
+  // (2) Collect <month> elements /////////////////////////////////////////////
+
+  qint64 line = 1 + xmlCountLines(content, 0, pos);
+  while( true ) {
+    const int lt = content.indexOf('<', pos);
+    if( lt < 0 ) {
       return false;
     }
+
+    for(int i = pos; i < lt; i++) {
+      if( !xmlIsSpace(content[i]) ) {
+        return false;
+      }
+    }
+    line += xmlCountLines(content, pos, lt);
+
+    if( xmlIsTagAt(content, lt, "</months") ) {
+      break;
+    }
+
+    if( !xmlIsTagAt(content, lt, "<month") ) {
+      return false;
+    }
+
+    const int gt = content.indexOf('>', lt);
+    if( gt < 0 ) {
+      return false;
+    }
+
+    int end = gt + 1;
+    if( content[gt - 1] != '/' ) {
+      const int close = xmlFindTag(content, "</month", gt);
+      const int closeGt = close >= 0
+          ? content.indexOf('>', close)
+          : -1;
+      if( closeGt < 0 ) {
+        return false;
+      }
+
+      end = closeGt + 1;
+    }
+
+    XmlMonthFragment fragment;
+    fragment.begin = lt;
+    fragment.end   = end;
+    fragment.line  = line;
+    fragments.push_back(std::move(fragment));
+
+    line += xmlCountLines(content, lt, end);
+    pos = end;
   }
 
   return true;
 }
 
-////// Private - Read Projects ///////////////////////////////////////////////
+QByteArray xmlSkeleton(const QByteArray& content, const XmlMonthFragments& fragments)
+{
+  // NOTE: Month elements are replaced by their line breaks to retain line numbers.
+  QByteArray result;
+  result.reserve(content.size());
+
+  int pos = 0;
+  for(const XmlMonthFragment& fragment : fragments) {
+    result.append(content.constData() + pos, fragment.begin - pos);
+    result.append(int(xmlCountLines(content, fragment.begin, fragment.end)), '\n');
+    pos = fragment.end;
+  }
+  result.append(content.constData() + pos, content.size() - pos);
 
-bool xmlReadProject(Context& context, const QDomElement& xml_project)
+  return result;
+}
+
+void xmlReadMonthFragment(XmlMonthFragment& fragment, const QByteArray& content)
 {
-  if( !xmlIsTag(xml_project, XML_project) ) {
-    return true; // successfully ignored
+  const QByteArray data =
+      QByteArray::fromRawData(content.constData() + fragment.begin,
+                              fragment.end - fragment.begin);
+
+  QBuffer buffer;
+  xmlOpenBuffer(buffer, data);
+
+  QXmlStreamReader xml(&buffer);
+
+  if( xml.readNextStartElement()  &&  xmlReadMonth(fragment.month, xml) ) {
+    while( !xml.atEnd() ) {
+      xml.readNext();
+    }
   }
 
-  const projectid_t id =
-      xmlAttributeValue<projectid_t>(xml_project, XML_pid, INVALID_PROJECTID);
-  if( id == INVALID_PROJECTID ) {
-    return false;
+  if( xml.hasError() ) {
+    fragment.error       = xml.errorString();
+    fragment.errorLine   = fragment.line + xml.lineNumber() - 1;
+    fragment.errorColumn = xml.columnNumber();
   }
+}
 
-  const QDomElement xml_name = xml_project.firstChildElement(XML_name);
-  if( xml_name.isNull() ) {
-    return false;
+class XmlMonthTask : public QRunnable {
+public:
+  XmlMonthTask(const QByteArray& content,
+               XmlMonthFragments::iterator first,
+               XmlMonthFragments::iterator last) noexcept
+    : _content(content)
+    , _first(first)
+    , _last(last)
+  {
   }
 
-  const QString name = xml_name.text().trimmed();
+  void run() final
+  {
+    for(auto it = _first; it != _last; ++it) {
+      xmlReadMonthFragment(*it, _content);
+    }
+  }
 
-  const QDomElement xml_annotation = xml_project.firstChildElement(XML_annotation);
-  const QString annotation = xml_annotation.text().trimmed();
+private:
+  const QByteArray& _content;
+  XmlMonthFragments::iterator _first;
+  XmlMonthFragments::iterator _last;
+};
 
-  if( !context.add({id, name, annotation}) ) {
+bool xmlReadParallel(Context& context, const QByteArray& content,
+                     XmlMonthFragments& fragments, IoError *error)
+{
+  // (1) Parse months on the thread pool /////////////////////////////////////
+
+  QThreadPool pool;
+  pool.setMaxThreadCount(QThread::idealThreadCount());
+
+  const std::size_t numTasks  = std::size_t(pool.maxThreadCount())*4;
+  const std::size_t batchSize = std::max<std::size_t>(1, fragments.size()/numTasks);
+
+  for(std::size_t i = 0; i < fragments.size(); i += batchSize) {
+    const std::size_t last = std::min(i + batchSize, fragments.size());
+    pool.start(new XmlMonthTask(content,
+                                fragments.begin() + std::ptrdiff_t(i),
+                                fragments.begin() + std::ptrdiff_t(last)));
+  }
+
+  // (2) Parse remaining document on this thread /////////////////////////////
+
+  QBuffer skeleton;
+  xmlOpenBuffer(skeleton, xmlSkeleton(content, fragments));
+
+  QXmlStreamReader xml(&skeleton);
+  const bool ok = xmlRead(context, xml, error);
+
+  pool.waitForDone();
+
+  if( !ok ) {
     return false;
   }
 
+  // (3) Merge months ////////////////////////////////////////////////////////
+
+  for(XmlMonthFragment& fragment : fragments) {
+    if( !fragment.error.isEmpty() ) {
+      return setIoError(error, IoError::ReadError, fragment.error,
+                        fragment.errorLine, fragment.errorColumn);
+    }
+
+    for(const Item& item : fragment.month.items) {
+      if( !context.isProject(item.projectId) ) {
+        return setIoError(error, IoError::ReadError,
+                          QCoreApplication::translate(TR_CTX, "Invalid project ID %1!")
+                          .arg(item.projectId),
+                          fragment.line, 1);
+      }
+    }
+
+    const monthid_t mid = fragment.month.id();
+    if( !context.add(std::move(fragment.month)) ) {
+      return setIoError(error, IoError::ReadError,
+                        QCoreApplication::translate(TR_CTX, "Invalid month %1!")
+                        .arg(mid),
+                        fragment.line, 1);
+    }
+
+    // NOTE: Deep copy; the content may be a mapped file.
+    context.cacheMonthFragment(mid, QByteArray(content.constData() + fragment.begin,
+                                               fragment.end - fragment.begin));
+  }
+
   return true;
 }
 
-bool xmlReadProjects(Context& context, const QDomElement& xml_root)
+////// Private - Lazy Read ///////////////////////////////////////////////////
+
+monthid_t xmlFragmentMonthId(const QByteArray& content, const XmlMonthFragment& fragment)
 {
-  const QDomElement xml_projects = xml_root.firstChildElement(XML_projects);
-  if( xml_projects.isNull() ) {
-    return true; // Optional
+  const int gt = content.indexOf('>', fragment.begin);
+  if( gt < 0 ) {
+    return INVALID_MONTHID;
   }
 
-  for(QDomElement xml_project = xml_projects.firstChildElement();
-      !xml_project.isNull();
-      xml_project = xml_project.nextSiblingElement()) {
-    if( !xmlReadProject(context, xml_project) ) {
-      return false;
+  int pos = content.indexOf("mid", fragment.begin);
+  while( pos >= 0  &&  pos < gt  &&  !xmlIsSpace(content[pos - 1]) ) {
+    pos = content.indexOf("mid", pos + 1);
+  }
+  if( pos < 0  ||  pos >= gt ) {
+    return INVALID_MONTHID;
+  }
+
+  for(pos += 3; pos < gt  &&  xmlIsSpace(content[pos]); pos++) {
+  }
+  if( pos >= gt  ||  content[pos] != '=' ) {
+    return INVALID_MONTHID;
+  }
+
+  for(pos += 1; pos < gt  &&  xmlIsSpace(content[pos]); pos++) {
+  }
+  if( pos >= gt  ||  (content[pos] != '"'  &&  content[pos] != '\'') ) {
+    return INVALID_MONTHID;
+  }
+
+  const int end = content.indexOf(content[pos], pos + 1);
+  if( end < 0  ||  end >= gt ) {
+    return INVALID_MONTHID;
+  }
+
+  monthid_t mid{INVALID_MONTHID};
+  if( !Parse::toValue(content.constData() + pos + 1, content.constData() + end, mid) ) {
+    return INVALID_MONTHID;
+  }
+
+  return mid;
+}
+
+bool xmlReadLazy(Context& context, const QByteArray& content,
+                 const XmlMonthFragments& fragments, IoError *error)
+{
+  // (1) Parse document without months ///////////////////////////////////////
+
+  QBuffer skeleton;
+  xmlOpenBuffer(skeleton, xmlSkeleton(content, fragments));
+
+  QXmlStreamReader xml(&skeleton);
+  if( !xmlRead(context, xml, error) ) {
+    return false;
+  }
+
+  // (2) Index months ////////////////////////////////////////////////////////
+
+  for(const XmlMonthFragment& fragment : fragments) {
+    const monthid_t mid = xmlFragmentMonthId(content, fragment);
+
+    // NOTE: Deep copy; the content may be a mapped file.
+    QByteArray data(content.constData() + fragment.begin, fragment.end - fragment.begin);
+
+    if( !context.add(mid, std::move(data)) ) {
+      return setIoError(error, IoError::ReadError,
+                        QCoreApplication::translate(TR_CTX, "Invalid month %1!")
+                        .arg(mid),
+                        fragment.line, 1);
     }
   }
 
@@ -262,174 +740,319 @@ bool xmlReadProjects(Context& context, const QDomElement& xml_root)
 
 ////// Private - Write Months ////////////////////////////////////////////////
 
-void xmlWriteHours(QDomDocument& doc, QDomElement& xml_item, const Item& item)
+// NOTE: Formatted once; i.e. writing a day allocates no attribute value.
+const QString& xmlDayId(const std::size_t day)
 {
-  constexpr numhour_t ZERO = 0;
+  static const std::array<QString,Hours::size()> ids = []() {
+    std::array<QString,Hours::size()> result;
+    for(std::size_t i = 0; i < result.size(); i++) {
+      result[i] = QString::number(i);
+    }
+    return result;
+  }();
+
+  return ids[day];
+}
 
-  if( item.sumHours() == ZERO ) {
+void xmlWriteHours(QXmlStreamWriter& xml, const Item& item)
+{
+  if( item.hours.isEmpty() ) {
     return; // Optional
   }
 
-  QDomElement xml_hours = doc.createElement(XML_hours);
-  xml_item.appendChild(xml_hours);
+  xml.writeStartElement(XML_hours);
 
-  for(std::size_t i = 0; i < item.hours.size(); i++) {
-    if( item.hours[i] == ZERO ) {
-      continue;
-    }
+  QString text;
+  text.reserve(int(Format::HOURS_SIZE));
 
-    QDomElement xml_day = doc.createElement(XML_day);
-    xml_day.setAttribute(XML_did, i);
-    xml_hours.appendChild(xml_day);
+  item.hours.forEachDay([&](const std::size_t day, const numhour_t hours) -> void {
+    Format::toString(text, hours);
 
-    QDomText xml_text = doc.createTextNode(toQString(item.hours[i]));
-    xml_day.appendChild(xml_text);
-  }
+    xml.writeStartElement(XML_day);
+    xml.writeAttribute(XML_did, xmlDayId(day));
+    xml.writeCharacters(text);
+    xml.writeEndElement();
+  });
+
+  xml.writeEndElement();
 }
 
-void xmlWriteItem(QDomDocument& doc, QDomElement& xml_items, const Item& item)
+void xmlWriteItem(QXmlStreamWriter& xml, const Item& item)
 {
-  QDomElement xml_item = doc.createElement(XML_item);
-  xml_item.setAttribute(XML_pid, item.projectId);
-  xml_items.appendChild(xml_item);
+  xml.writeStartElement(XML_item);
+  xml.writeAttribute(XML_pid, QString::number(item.projectId));
 
-  QDomElement xml_activity = doc.createElement(XML_activity);
-  xml_item.appendChild(xml_activity);
+  xml.writeTextElement(XML_activity, item.activity);
 
-  QDomText xml_text = doc.createTextNode(item.activity);
-  xml_activity.appendChild(xml_text);
+  xmlWriteHours(xml, item);
 
-  xmlWriteHours(doc, xml_item, item);
+  xml.writeEndElement();
 }
 
-void xmlWriteItems(QDomDocument& doc, QDomElement& xml_month, const Items& items)
+void xmlWriteItems(QXmlStreamWriter& xml, const Items& items)
 {
   if( items.empty() ) {
     return; // Optional
   }
 
-  QDomElement xml_items = doc.createElement(XML_items);
-  xml_month.appendChild(xml_items);
+  xml.writeStartElement(XML_items);
 
   for(const Item& item : items) {
-    xmlWriteItem(doc, xml_items, item);
+    xmlWriteItem(xml, item);
   }
+
+  xml.writeEndElement();
 }
 
-void xmlWriteMonth(QDomDocument& doc, QDomElement& xml_months, const Month& month)
+void xmlWriteMonth(QXmlStreamWriter& xml, const Month& month)
 {
-  QDomElement xml_month = doc.createElement(XML_month);
-  xml_month.setAttribute(XML_mid, month.id());
-  xml_months.appendChild(xml_month);
+  xml.writeStartElement(XML_month);
+  xml.writeAttribute(XML_mid, QString::number(month.id()));
+
+  xmlWriteItems(xml, month.items);
 
-  xmlWriteItems(doc, xml_month, month.items);
+  xml.writeEndElement();
 }
 
-void xmlWriteMonths(QDomDocument& doc, QDomElement& xml_root, const Context& context)
+////// Private - Write Projects //////////////////////////////////////////////
+
+void xmlWriteProject(QXmlStreamWriter& xml, const Project& project)
 {
-  const MonthIDs months = context.listMonths();
-  if( months.empty() ) {
-    return; // Optional
-  }
+  xml.writeStartElement(XML_project);
+  xml.writeAttribute(XML_pid, QString::number(project.id()));
 
-  QDomElement xml_months = doc.createElement(XML_months);
-  xml_root.appendChild(xml_months);
+  xml.writeTextElement(XML_name, project.name);
+  xml.writeTextElement(XML_annotation, project.annotation);
 
-  for(const monthid_t id : months) {
-    const Month *m = context.findMonth(id);
-    if( m == nullptr ) {
-      continue;
-    }
+  xml.writeEndElement();
+}
 
-    xmlWriteMonth(doc, xml_months, *m);
-  }
+////// Private - Write Document //////////////////////////////////////////////
+
+/*
+ * NOTE: Months and projects are serialized as independent fragments, which
+ *       are cached by the Context as long as they are not modified. Writing
+ *       never modifies the Context; newly serialized fragments are returned
+ *       to the caller instead. The document itself is assembled from the
+ *       fragments, reproducing the layout of a QXmlStreamWriter with auto
+ *       formatting.
+ */
+
+constexpr int XML_INDENT = 2;
+
+inline QByteArray xmlIndent(const int depth)
+{
+  return '\n' + QByteArray(depth*XML_INDENT, ' ');
 }
 
-////// Private - Write Projects //////////////////////////////////////////////
+template<typename WriteFunc>
+QByteArray xmlSerialize(const QString& section, WriteFunc&& func)
+{
+  QBuffer buffer;
+  buffer.open(QIODevice::WriteOnly);
+
+  QXmlStreamWriter xml(&buffer);
+  xml.setAutoFormatting(true);
+  xml.setAutoFormattingIndent(XML_INDENT);
+  xml.setCodec("UTF-8");
+
+  // Nest the fragment at its depth in the document to get its indentation...
+  xml.writeStartElement(XML_HourGlass);
+  xml.writeStartElement(section);
 
-void xmlWriteProject(QDomDocument& doc, QDomElement& xml_projects, const Project& project)
+  const qint64 pos = buffer.pos();
+  func(xml);
+  const qint64 end = buffer.pos();
+
+  const QByteArray& data = buffer.data();
+  const int begin = data.indexOf('<', int(pos));
+
+  return begin >= 0
+      ? data.mid(begin, int(end) - begin)
+      : QByteArray();
+}
+
+inline bool xmlWriteRaw(QIODevice *device, const QByteArray& data)
 {
-  QDomElement xml_project = doc.createElement(XML_project);
-  xml_project.setAttribute(XML_pid, project.id());
+  return device->write(data) == qint64(data.size());
+}
 
-  QDomElement xml_name = doc.createElement(XML_name);
-  xml_name.appendChild(doc.createTextNode(project.name));
-  xml_project.appendChild(xml_name);
+inline bool xmlWriteTag(QIODevice *device, const int depth, const QString& name,
+                        const bool is_end = false)
+{
+  QByteArray tag = xmlIndent(depth);
+  tag += is_end
+      ? "</"
+      : "<";
+  tag += name.toUtf8();
+  tag += '>';
+
+  return xmlWriteRaw(device, tag);
+}
 
-  QDomElement xml_annotation = doc.createElement(XML_annotation);
-  xml_annotation.appendChild(doc.createTextNode(project.annotation));
-  xml_project.appendChild(xml_annotation);
+bool xmlWriteMonths(QIODevice *device, const Context& context, const MonthIDs& months,
+                    MonthFragments& fragments)
+{
+  if( months.empty() ) {
+    return true; // Optional
+  }
+
+  if( !xmlWriteTag(device, 1, XML_months) ) {
+    return false;
+  }
+
+  const QByteArray indent = xmlIndent(2);
+  for(const monthid_t id : months) {
+    QByteArray fragment = context.monthFragment(id);
+    if( fragment.isEmpty() ) {
+      const Month *m = context.findMonth(id);
+      if( m == nullptr ) {
+        return false;
+      }
+
+      fragment = xmlSerialize(XML_months, [&](QXmlStreamWriter& xml) -> void {
+        xmlWriteMonth(xml, *m);
+      });
+      fragments.insert_or_assign(to_monthord(id), fragment);
+    }
+
+    if( !xmlWriteRaw(device, indent)  ||  !xmlWriteRaw(device, fragment) ) {
+      return false;
+    }
+  }
 
-  xml_projects.appendChild(xml_project);
+  return xmlWriteTag(device, 1, XML_months, true);
 }
 
-void xmlWriteProjects(QDomDocument& doc, QDomElement& xml_root, const Context& context)
+bool xmlWriteProjects(QIODevice *device, const Context& context, const ProjectIDs& projects,
+                      ProjectFragments& fragments)
 {
-  const ProjectIDs projects = context.listProjects();
   if( projects.empty() ) {
-    return; // Optional
+    return true; // Optional
   }
 
-  QDomElement xml_projects = doc.createElement(XML_projects);
-  xml_root.appendChild(xml_projects);
+  if( !xmlWriteTag(device, 1, XML_projects) ) {
+    return false;
+  }
 
+  const QByteArray indent = xmlIndent(2);
   for(const projectid_t id : projects) {
-    const Project *p = context.findProject(id);
-    if( p == nullptr ) {
-      continue;
+    QByteArray fragment = context.projectFragment(id);
+    if( fragment.isEmpty() ) {
+      const Project *p = context.findProject(id);
+      if( p == nullptr ) {
+        continue;
+      }
+
+      fragment = xmlSerialize(XML_projects, [&](QXmlStreamWriter& xml) -> void {
+        xmlWriteProject(xml, *p);
+      });
+      fragments.insert_or_assign(id, fragment);
     }
 
-    xmlWriteProject(doc, xml_projects, *p);
+    if( !xmlWriteRaw(device, indent)  ||  !xmlWriteRaw(device, fragment) ) {
+      return false;
+    }
   }
-}
 
-////// Public ////////////////////////////////////////////////////////////////
+  return xmlWriteTag(device, 1, XML_projects, true);
+}
 
-bool xmlRead(Context& context, const QString& xmlContent, QWidget *parent)
+bool xmlWriteDocument(QIODevice *device, const Context& context, XmlFragments& fragments)
 {
-  context.clear();
-
-  QDomDocument doc;
+  const ProjectIDs projects = context.listProjects();
+  const MonthIDs     months = context.listMonths();
 
-  QString errmsg;
-  int line, column;
-  if( !doc.setContent(xmlContent, &errmsg, &line, &column) ) {
-    QMessageBox::critical(parent, QCoreApplication::translate(TR_CTX, "Error"),
-                          QCoreApplication::translate(TR_CTX, "XML(%1,%2):\n\"%3\"")
-                          .arg(line)
-                          .arg(column)
-                          .arg(errmsg));
+  if( !xmlWriteRaw(device, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>") ) {
     return false;
   }
 
-  const QDomElement xml_root = doc.firstChildElement(XML_HourGlass);
-  if( xml_root.isNull() ) {
-    return false;
+  if( projects.empty()  &&  months.empty() ) {
+    return xmlWriteRaw(device, xmlIndent(0) + XML_HourGlass.toUtf8() + "/>\n");
   }
 
-  if( !xmlReadProjects(context, xml_root) ) {
-    return false;
+  return
+      xmlWriteTag(device, 0, XML_HourGlass)         &&
+      xmlWriteProjects(device, context, projects, fragments.projects)  &&
+      xmlWriteMonths(device, context, months, fragments.months)        &&
+      xmlWriteTag(device, 0, XML_HourGlass, true)  &&
+      xmlWriteRaw(device, "\n");
+}
+
+////// Public ////////////////////////////////////////////////////////////////
+
+bool xmlRead(Context& context, const QByteArray& xmlContent, IoError *error,
+             const bool lazy, const bool parallel)
+{
+  XmlMonthFragments fragments;
+  const bool is_scanned = xmlScanMonths(fragments, xmlContent);
+
+  if( is_scanned  &&  lazy ) {
+    return xmlReadLazy(context, xmlContent, fragments, error);
   }
 
-  if( !xmlReadMonths(context, xml_root) ) {
-    return false;
+  if( is_scanned                                  &&
+      parallel                                    &&
+      QThread::idealThreadCount() > 1             &&
+      fragments.size() >= PARALLEL_MIN_MONTHS ) {
+    return xmlReadParallel(context, xmlContent, fragments, error);
   }
 
-  return true;
+  QBuffer buffer;
+  xmlOpenBuffer(buffer, xmlContent);
+
+  QXmlStreamReader xml(&buffer);
+
+  return xmlRead(context, xml, error);
 }
 
-QString xmlWrite(const Context& context, QWidget * /*parent*/)
+bool xmlRead(Context& context, QIODevice *device, IoError *error)
 {
-  QDomDocument doc;
+  QXmlStreamReader xml(device);
 
-  QDomProcessingInstruction pi = doc.createProcessingInstruction(XML_pitarget, XML_pidata);
-  doc.appendChild(pi);
+  return xmlRead(context, xml, error);
+}
 
-  QDomElement xml_root = doc.createElement(XML_HourGlass);
-  doc.appendChild(xml_root);
+bool xmlReadMonth(Month& month, const QByteArray& xmlFragment, IoError *error)
+{
+  QBuffer buffer;
+  xmlOpenBuffer(buffer, xmlFragment);
+
+  QXmlStreamReader xml(&buffer);
 
-  xmlWriteProjects(doc, xml_root, context);
-  xmlWriteMonths(doc, xml_root, context);
+  const bool ok =
+      xml.readNextStartElement()  &&
+      xml.name() == XML_month     &&
+      xmlReadMonth(month, xml);
 
-  return doc.toString(2);
+  while( ok  &&  !xml.atEnd() ) {
+    xml.readNext();
+  }
+
+  if( !ok  ||  xml.hasError() ) {
+    // NOTE: Line numbers are relative to the fragment; hence they are omitted.
+    return xml.hasError()
+        ? setIoError(error, IoError::ReadError, xml.errorString())
+        : setIoError(error, IoError::ReadError,
+                     QCoreApplication::translate(TR_CTX, "Invalid XML document!"));
+  }
+
+  return true;
+}
+
+bool xmlWrite(QIODevice *device, const Context& context, IoError *error,
+              XmlFragments *fragments)
+{
+  XmlFragments written;
+  if( !xmlWriteDocument(device, context, written) ) {
+    return setIoError(error, IoError::WriteError,
+                      QCoreApplication::translate(TR_CTX, "Unable to write XML data! (%1)")
+                      .arg(device->errorString()));
+  }
+
+  if( fragments != nullptr ) {
+    *fragments = std::move(written);
+  }
+
+  return true;
 }
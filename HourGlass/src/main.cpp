@@ -39,9 +39,12 @@ int main(int argc, char **argv)
   QLocale::setDefault(QLocale::system());
 
   QApplication app(argc, argv);
+  app.setOrganizationName(QStringLiteral("csLabs"));
+  app.setApplicationName(QStringLiteral("HourGlass"));
 
   WMainWindow *mainwindow = new WMainWindow();
   mainwindow->show();
+  mainwindow->recover();
 
   const int result = app.exec();
   delete mainwindow;